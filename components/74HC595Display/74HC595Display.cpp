@@ -2,13 +2,9 @@
 #include "esphome/core/log.h"
 #include "esphome/core/helpers.h"
 #include "esphome/core/hal.h"
-
-#define SET_LED(value)                                      \
-    gpio_set_level(ShiftData, m_inverted ? !value : value); \
-    delayMicroseconds(1);                                   \
-    gpio_set_level(ShiftClock, HIGH);                       \
-    delayMicroseconds(1);                                   \
-    gpio_set_level(ShiftClock, LOW);
+#ifdef USE_LED_DISPLAY_INGEST
+#include "esphome/components/network/util.h"
+#endif
 
 namespace esphome
 {
@@ -23,14 +19,32 @@ namespace esphome
         {
             ESP_LOGCONFIG(TAG, "Setting up 74HC595Display...");
 
-            this->stepsleft_ = 0;
-            for (int chip_line = 0; chip_line < this->num_chip_lines_; chip_line++)
+            if (this->num_chip_lines_ > this->rows.size())
             {
-                std::vector<bool> vec(1);
-                this->led_displaybuffer_.push_back(vec);
-                // Initialize buffer with 0 for display so all non written pixels are blank
-                this->led_displaybuffer_[chip_line].resize(get_width_internal(), 0);
+                ESP_LOGW(TAG, "Only %u row pins available, limiting num_chip_lines", (unsigned)this->rows.size());
+                this->num_chip_lines_ = this->rows.size();
             }
+            if (!this->geometry_.init(this->num_chips_ * 8, this->num_chip_lines_))
+            {
+                ESP_LOGE(TAG, "The chain order must list every tile once");
+                this->mark_failed();
+                return;
+            }
+
+            this->scroll_offset_ = 0;
+            // Initialize buffer with 0 for display so all non written pixels are blank
+            // Allocated once, text scrolling past max_width is cut off instead of growing the heap
+            const uint8_t planes = this->gray_scale_ ? BRIGHTNESS_BITS : 1;
+            this->buffer_.init(get_height_internal(), get_width_internal(), this->max_width_, planes);
+            this->marquee_.init(get_height_internal(), get_width_internal(), planes, this->font_);
+            // Every glyph advances at least one column, so this holds any text that fits the canvas
+            this->text_format_.resize(this->max_width_ + 1);
+            if (!this->geometry_.is_direct())
+                this->window_.init(get_height_internal(), get_width_internal(), 0, planes);
+#ifdef USE_LED_DISPLAY_INGEST
+            if (this->ingest_port_ != 0)
+                this->ingest_spare_.init(get_height_internal(), get_width_internal(), 0, planes);
+#endif
             /*
             // let's assume the user has all 8 digits connected, only important in daisy chained setups anyway
             this->send_to_all_(MAX7219_REGISTER_SCAN_LIMIT, 7);
@@ -49,342 +63,1389 @@ namespace esphome
             // set IO to output
             for (auto row : rows)
             {
-                pinMode(row, OUTPUT);
+                panel_pin_setup(row);
             }
-            pinMode(ShiftClock, OUTPUT);
-            pinMode(ShiftData, OUTPUT);
-            pinMode(ShiftClear, OUTPUT);
-            pinMode(MasterClr, OUTPUT);
+            // The clear pins reach the chains of every panel, only the first one resets them
+            if (get_scan_scheduler().get_panels() == 0)
+            {
+                panel_pin_setup(ShiftClear);
+                panel_pin_setup(MasterClr);
 
-            // clear and reset display
-            digitalWrite(ShiftClear, 0); //default level LOW
-            digitalWrite(MasterClr, 0);
-            delayMicroseconds(10);
-            digitalWrite(MasterClr, 1); //reset display
+                // clear and reset display
+                panel_pin_write(ShiftClear, false); //default level LOW
+                panel_pin_write(MasterClr, false);
+                delayMicroseconds(10);
+                panel_pin_write(MasterClr, true); //reset display
+            }
 
-            if (m_flipped)
+            if (this->flipped_)
             {
-                std::reverse(rows.begin(), rows.end());
+                // only the pins of the lines in use, spare pins at the end stay spare
+                std::reverse(rows.begin(), rows.begin() + std::min<size_t>(this->num_chip_lines_, rows.size()));
             }
+
+            if (!this->setup_transport_())
+            {
+                this->mark_failed();
+                return;
+            }
+
+            // start the background row scan
+            this->scan_frames_.init(this->geometry_.scan_rows(), this->geometry_.chain_bits(), planes);
+            this->base_row_period_us_ = 1000000UL / (this->refresh_rate_ * this->geometry_.scan_rows());
+            if (this->row_on_time_us_ == 0 || this->row_on_time_us_ > this->base_row_period_us_)
+                this->row_on_time_us_ = this->base_row_period_us_;
+            this->base_row_on_time_us_ = this->row_on_time_us_;
+            this->scan_rate_ = this->refresh_rate_;
+            this->scan_line_ = this->geometry_.scan_rows() - 1;
+            if (!this->scan_timer_.begin(&LedDisplayComponent::scan_timer_callback_, this, this->scan_task_))
+            {
+                ESP_LOGE(TAG, "Could not start the row scan");
+                this->mark_failed();
+                return;
+            }
+            this->apply_scan_rate_(this->refresh_rate_);
+            this->scan_timer_.schedule_next(0);
+
+            if (!this->playlist_.empty())
+                this->playlist_start();
+        }
+
+        bool LedDisplayComponent::setup_transport_()
+        {
+            // Panels on the same transport and data pins share it, they drive the same chain pins
+            ScanScheduler &scheduler = get_scan_scheduler();
+            this->transport_ = scheduler.find_transport(this->transport_type_, this->parallel_data_pins_);
+            if (this->transport_ != nullptr)
+            {
+                const uint16_t max_bits = this->transport_->get_max_bits();
+                if (max_bits != 0 && this->geometry_.chain_bits() > max_bits)
+                {
+                    ESP_LOGE(TAG, "The shared %s output transport takes at most %u columns, list the longest panel first",
+                             this->transport_->get_name(), (unsigned)max_bits);
+                    return false;
+                }
+                return true;
+            }
+
+            std::unique_ptr<OutputTransport> transport;
+            switch (this->transport_type_)
+            {
+#ifdef USE_ESP32
+            case TRANSPORT_GPIO:
+                transport.reset(new GpioTransport(ShiftData, ShiftClock, LatchClock));
+                break;
+            case TRANSPORT_SPI:
+                transport.reset(new SpiTransport(ShiftData, ShiftClock, LatchClock, this->data_rate_, this->geometry_.chain_bits()));
+                break;
+            case TRANSPORT_PARALLEL:
+                transport.reset(new ParallelGpioTransport(this->parallel_data_pins_, ShiftClock, LatchClock));
+                break;
+#endif
+            default:
+                // Host builds have no pins, only the row on the outputs is kept
+                transport.reset(new RecordingTransport(0));
+                break;
+            }
+            if (!transport->setup())
+            {
+                ESP_LOGE(TAG, "Could not set up the %s output transport", transport->get_name());
+                return false;
+            }
+            // The scheduler owns it, the panels sharing it only borrow it
+            this->transport_ = scheduler.add_transport(this->transport_type_, this->parallel_data_pins_, std::move(transport));
+            return true;
+        }
+
+        void LedDisplayComponent::on_shutdown()
+        {
+            // Stop the scanner before the rows are switched off, so it can not light one again
+            this->scan_timer_.end();
+            for (auto row : this->rows)
+                panel_pin_write(row, false);
         }
 
         void LedDisplayComponent::dump_config()
         {
             ESP_LOGCONFIG(TAG, "74HC595Display:");
 
-            ESP_LOGCONFIG(TAG, "  Scroll Mode: %u", this->scroll_mode_);
-            ESP_LOGCONFIG(TAG, "  Scroll Speed: %u", this->scroll_speed_);
-            ESP_LOGCONFIG(TAG, "  Scroll Dwell: %u", this->scroll_dwell_);
-            ESP_LOGCONFIG(TAG, "  Scroll Delay: %u", this->scroll_delay_);
+            ESP_LOGCONFIG(TAG, "  Font: %s", this->font_type_ == FONT_5X7_PROPORTIONAL ? "5x7 proportional" : "5x7");
+            ESP_LOGCONFIG(TAG, "  Scroll Mode: %u", (unsigned)this->scroll_mode_);
+            ESP_LOGCONFIG(TAG, "  Scroll Speed: %u", (unsigned)this->scroll_speed_);
+            ESP_LOGCONFIG(TAG, "  Scroll Dwell: %u", (unsigned)this->scroll_dwell_);
+            ESP_LOGCONFIG(TAG, "  Scroll Delay: %u", (unsigned)this->scroll_delay_);
+            ESP_LOGCONFIG(TAG, "  Output Transport: %s", this->transport_ != nullptr ? this->transport_->get_name() : "none");
+            if (this->transport_type_ == TRANSPORT_SPI)
+                ESP_LOGCONFIG(TAG, "  Data Rate: %u Hz", (unsigned)this->data_rate_);
+            if (this->transport_type_ == TRANSPORT_PARALLEL)
+                ESP_LOGCONFIG(TAG, "  Parallel Chains: %u", (unsigned)this->parallel_data_pins_.size());
+            ESP_LOGCONFIG(TAG, "  Panel: %u x %u, %u x %u tiles", (unsigned)(this->num_chips_ * 8), (unsigned)this->num_chip_lines_,
+                          (unsigned)this->geometry_.tiles_x(), (unsigned)this->geometry_.tiles_y());
+            ESP_LOGCONFIG(TAG, "  Mirror Columns: %s", YESNO(this->reverse_));
+            ESP_LOGCONFIG(TAG, "  Flip Rows: %s", YESNO(this->flipped_));
+            ESP_LOGCONFIG(TAG, "  Scan Task: %s", YESNO(get_scan_scheduler().is_task()));
+            if (get_scan_scheduler().get_panels() > 1)
+                ESP_LOGCONFIG(TAG, "  Shared Scan: %u panels", (unsigned)get_scan_scheduler().get_panels());
+            ESP_LOGCONFIG(TAG, "  Row Shift Time: %u us", (unsigned)this->row_shift_time_us_.load());
+            ESP_LOGCONFIG(TAG, "  Refresh Rate: %u Hz", (unsigned)this->refresh_rate_);
+            ESP_LOGCONFIG(TAG, "  Row Period: %u us", (unsigned)this->row_period_us_);
+            ESP_LOGCONFIG(TAG, "  Row On-Time: %u us", (unsigned)this->row_on_time_us_);
+            if (this->idle_refresh_rate_ != 0)
+                ESP_LOGCONFIG(TAG, "  Idle Refresh Rate: %u Hz after %u ms", (unsigned)this->idle_refresh_rate_, (unsigned)this->idle_after_);
+            ESP_LOGCONFIG(TAG, "  Skip Blank Rows: %s", YESNO(this->skip_blank_rows_));
+            ESP_LOGCONFIG(TAG, "  Brightness: %u/%u", (unsigned)this->brightness_.load(), (unsigned)MAX_BRIGHTNESS);
+            ESP_LOGCONFIG(TAG, "  Gray Scale: %s", YESNO(this->gray_scale_));
+#ifdef USE_LED_DISPLAY_INGEST
+            if (this->ingest_port_ != 0)
+                ESP_LOGCONFIG(TAG, "  Ingest: UDP port %u, timeout %u ms", (unsigned)this->ingest_port_, (unsigned)this->ingest_timeout_);
+#endif
+            if (!this->playlist_.empty())
+                ESP_LOGCONFIG(TAG, "  Playlist: %u messages, arena %u columns", (unsigned)this->playlist_.size(), (unsigned)this->playlist_arena_width_);
+
+            ESP_LOGCONFIG(TAG, "  Frames Scanned: %u", (unsigned)this->frames_.load());
+            ESP_LOGCONFIG(TAG, "  Missed Scan Deadlines: %u", (unsigned)this->scan_timer_.get_missed());
+            ESP_LOGCONFIG(TAG, "  Max Row Jitter: %u us", (unsigned)this->max_jitter_us_.load());
+            ESP_LOGCONFIG(TAG, "  Max Loop Time: %u us", (unsigned)this->max_loop_us_);
+            char histogram[160];
+            this->jitter_histogram_.format(histogram, sizeof(histogram));
+            ESP_LOGCONFIG(TAG, "  Row Jitter Histogram: %s", histogram);
+            this->loop_histogram_.format(histogram, sizeof(histogram));
+            ESP_LOGCONFIG(TAG, "  Loop Time Histogram: %s", histogram);
+            ESP_LOGCONFIG(TAG, "  Update Time: %u us", (unsigned)this->update_us_);
+#ifdef USE_SENSOR
+            LOG_SENSOR("  ", "Frame Rate", this->frame_rate_sensor_);
+            LOG_SENSOR("  ", "Row Jitter", this->row_jitter_sensor_);
+            LOG_SENSOR("  ", "Loop Time", this->loop_time_sensor_);
+            LOG_SENSOR("  ", "Update Time", this->update_time_sensor_);
+            LOG_SENSOR("  ", "Missed Deadlines", this->missed_deadlines_sensor_);
+            LOG_SENSOR("  ", "Dropped Frames", this->dropped_frames_sensor_);
+            LOG_SENSOR("  ", "Late Frames", this->late_frames_sensor_);
+            LOG_SENSOR("  ", "Scan Time Saved", this->scan_saved_sensor_);
+            LOG_SENSOR("  ", "LED Duty", this->led_duty_sensor_);
+#endif
 
             LOG_UPDATE_INTERVAL(this);
         }
 
         void LedDisplayComponent::loop()
         {
-            uint32_t now = millis();
+            uint32_t start = micros();
 
-            // check if the buffer has shrunk past the current position since last update
-            if ((this->led_displaybuffer_[0].size() >= this->old_buffer_size_ + 3) ||
-                (this->led_displaybuffer_[0].size() <= this->old_buffer_size_ - 3))
-            {
-                this->stepsleft_ = 0;
+            const uint32_t now = millis();
+#ifdef USE_LED_DISPLAY_INGEST
+            if (this->ingest_port_ != 0)
+                this->ingest_step_(now);
+#endif
+            if (this->animation_active_)
+                this->animation_step_(now);
+            else if (this->marquee_active_)
+                this->marquee_step_(now);
+            else if (this->playlist_active_)
+                this->playlist_step_(now);
+            else
+                this->scroll_step_(now, this->buffer_.width(), this->scroll_, this->scroll_mode_, this->scroll_speed_);
+
+            if (this->frame_dirty_ && !this->ingest_active_)
                 this->display();
-                this->old_buffer_size_ = this->led_displaybuffer_[0].size();
+
+            // Static content needs no more than the lowest flicker free rate
+            if (this->idle_refresh_rate_ != 0)
+                this->scan_rate_ = now - this->last_publish_ >= this->idle_after_ ? this->idle_refresh_rate_ : this->refresh_rate_;
+
+            // Runs the due scans of every panel, unless they run from the timer or a task
+            get_scan_scheduler().poll();
+
+            uint32_t elapsed = micros() - start;
+            if (elapsed > this->max_loop_us_)
+                this->max_loop_us_ = elapsed;
+            this->loop_histogram_.add(elapsed);
+        }
+
+        bool LedDisplayComponent::scroll_step_(uint32_t now, uint16_t content, bool enable, ScrollMode mode, uint16_t speed)
+        {
+            const uint16_t visible = get_width_internal();
+            uint16_t offset = 0;
+            bool wrapped = false;
+
+            if (enable && (content > visible))
+            {
+                // The offset follows from the time into the pass, after a stall it jumps to where it
+                // should be and whole passes that were missed are skipped
+                const ScrollTimeline timeline{content, visible, mode, speed, this->scroll_delay_, this->scroll_dwell_};
+                const uint32_t period = timeline.period();
+                uint32_t elapsed = now - this->last_scroll_;
+                if (period != 0 && elapsed >= period)
+                {
+                    this->last_scroll_ += elapsed - elapsed % period;
+                    elapsed %= period;
+                    wrapped = true;
+                }
+                offset = timeline.offset(elapsed);
+            }
+            else
+            {
+                // No need to scroll or scroll is off, a pass starts when it is needed again. With scroll
+                // off the text stays at the column scroll_left() moved it to.
+                this->last_scroll_ = now;
+                if (!enable && content > visible)
+                    offset = this->scroll_offset_;
             }
 
-            // Reset the counter back to 0 when full string has been displayed.
-            if (this->stepsleft_ > this->led_displaybuffer_[0].size())
-                this->stepsleft_ = 0;
+            if (offset != this->scroll_offset_)
+            {
+                this->scroll_offset_ = offset;
+                this->frame_dirty_ = true;
+            }
+            return wrapped;
+        }
 
-            // Return if there is no need to scroll or scroll is off
-            if (!this->scroll_ || (this->led_displaybuffer_[0].size() <= (size_t)get_width_internal()))
+        void LedDisplayComponent::marquee_step_(uint32_t now)
+        {
+            // Text that fits is shown as is
+            if (!this->scroll_ || !this->marquee_.scrolls())
+                return;
+
+            if (this->marquee_.at_start() && (now - this->last_scroll_ < this->scroll_delay_))
+                return;
+
+            // Dwell at the end of the text in case of stop at end, then start over
+            if (this->scroll_mode_ == ScrollMode::STOP && this->marquee_.at_end())
             {
-                this->display();
+                if (now - this->last_scroll_ >= this->scroll_dwell_)
+                    this->marquee_start_();
                 return;
             }
 
-            if ((this->stepsleft_ == 0) && (now - this->last_scroll_ < this->scroll_delay_))
+            // Step all columns that are due, so a busy loop does not slow the text down. Beyond a
+            // display width nothing of the skipped columns would be seen, the text just restarts its timing.
+            const uint32_t visible = get_width_internal();
+            const uint32_t due = this->scroll_speed_ != 0 ? (now - this->last_scroll_) / this->scroll_speed_ : 1;
+            if (due == 0)
+                return;
+            this->last_scroll_ = due > visible ? now : this->last_scroll_ + due * this->scroll_speed_;
+            for (uint32_t i = 0; i < std::min(due, visible); i++)
+                this->marquee_.step(this->scroll_mode_ != ScrollMode::STOP);
+            this->frame_dirty_ = true;
+        }
+
+        void LedDisplayComponent::marquee(const std::string &text)
+        {
+            if (this->marquee_.set_text(text) || !this->marquee_active_)
+                this->marquee_start_();
+        }
+
+        void LedDisplayComponent::marquee(marquee_source_t source)
+        {
+            this->marquee_.set_source(std::move(source));
+            this->marquee_start_();
+        }
+
+        void LedDisplayComponent::stop_marquee()
+        {
+            this->marquee_active_ = false;
+            this->scroll_offset_ = 0;
+            this->last_scroll_ = millis();
+            this->frame_dirty_ = true;
+        }
+
+        void LedDisplayComponent::marquee_start_()
+        {
+            this->marquee_.restart();
+            this->marquee_active_ = true;
+            this->last_scroll_ = millis();
+            this->frame_dirty_ = true;
+        }
+
+#ifdef USE_LED_DISPLAY_INGEST
+        void LedDisplayComponent::ingest_step_(uint32_t now)
+        {
+            if (!this->ingest_.is_ready())
             {
-                this->display();
+                // The network stack only runs once connected, listen from then on
+                if (network::is_connected() && !this->ingest_.begin(this->ingest_port_))
+                    this->ingest_port_ = 0;
                 return;
             }
 
-            // Dwell time at end of string in case of stop at end
-            if (this->scroll_mode_ == ScrollMode::STOP)
+            // A few datagrams per loop, each frame is published as soon as it is complete
+            for (uint8_t i = 0; i < 4; i++)
             {
-                if (this->stepsleft_ >= this->led_displaybuffer_[0].size() - (size_t)get_width_internal() + 1)
+                const int size = this->ingest_.receive(this->ingest_spare_);
+                if (size < 0)
+                    break;
+                if (size > 0 && this->ingest_frame_(size))
                 {
-                    if (now - this->last_scroll_ >= this->scroll_dwell_)
-                    {
-                        this->stepsleft_ = 0;
-                        this->last_scroll_ = now;
-                        this->display();
-                    }
-                    return;
+                    this->ingest_last_ = now;
+                    this->ingest_active_ = true;
                 }
             }
 
-            // Actual call to scroll left action
-            if (now - this->last_scroll_ >= this->scroll_speed_)
+            if (this->ingest_active_ && now - this->ingest_last_ > this->ingest_timeout_)
             {
-                this->last_scroll_ = now;
-                this->scroll_left();
-                this->display();
+                // The sender went quiet, show the drawn content again
+                this->ingest_active_ = false;
+                this->ingest_.reset_sequence();
+                this->frame_dirty_ = true;
             }
+        }
 
-            void LedDisplayComponent::display()
+        bool LedDisplayComponent::ingest_frame_(int size)
+        {
+            const IngestHeader &header = this->ingest_.header();
+            const uint16_t visible = get_width_internal();
+            const uint8_t lines = get_height_internal();
+            const uint16_t width = header.width != 0 ? header.width : visible;
+            const uint16_t height = header.width != 0 ? header.height : lines;
+            const uint8_t planes = (header.flags & INGEST_LEVELS) ? BRIGHTNESS_BITS : 1;
+            const uint16_t stride = FrameBuffer::words_for(width);
+            if (height == 0 || header.x >= visible || header.y >= lines ||
+                planes > this->ingest_spare_.planes() || size != planes * height * stride * (int)sizeof(uint32_t))
             {
-                GPIOPin row;
-                for (uint8_t line = 0; line < this->get_height_internal(); line++)
+                this->ingest_.drop();
+                return false;
+            }
+            if (!this->ingest_.accept())
+                return false;
+
+            // With several tiles the frame goes through the window and the tile mapping like drawn content
+            const bool direct = this->geometry_.is_direct();
+            FrameBuffer &spare = this->ingest_spare_;
+            if (header.x == 0 && header.y == 0 && width == visible && height == lines)
+            {
+                // The pixels are in place already, keep the padding clear and fill in missing planes
+                for (uint8_t plane = 0; plane < spare.planes(); plane++)
                 {
-                    for (uint16_t j = 0; j < this->get_width_internal(); j++)
-                    {
-                        /*
-                    if (this->reverse_)
+                    for (uint8_t y = 0; y < lines; y++)
                     {
+                        if (plane >= planes)
+                            FrameBuffer::copy_bits(spare.row(y, 0), 0, spare.row(y, plane), 0, width);
+                        FrameBuffer::set_bits(spare.row(y, plane), width, stride * FrameBuffer::WORD_BITS - width, false);
                     }
-                    else
-                    {
-                    }
-                    */
-                        SET_LED(this->led_displaybuffer_[chip_line][j]);
-                    }
-                    row = rows[line];
-                    gpio_set_level(LatchClock, HIGH);
-                    delayMicroseconds(10);
-                    gpio_set_level(LatchClock, LOW);
-                    gpio_set_level(row, HIGH);
-                    delayMicroseconds(2000); //was 1000
-                    gpio_set_level(row, LOW);
                 }
+                if (direct)
+                    this->scan_frames_.swap_back(spare);
+                else
+                    std::swap(this->window_, spare);
             }
-
-            int LedDisplayComponent::get_height_internal()
+            else
             {
-                return this->num_chip_lines_;
+                // A rectangle goes over the current frame, cut off at the right and bottom edge. Its
+                // rows are `stride` words apart in the spare.
+                const uint16_t copy_width = std::min<uint16_t>(width, visible - header.x);
+                const uint8_t copy_height = std::min<uint16_t>(height, lines - header.y);
+                if (direct)
+                    this->ingest_catch_up_();
+                FrameBuffer &target = direct ? this->scan_frames_.back() : this->window_;
+                const uint32_t *src = spare.row(0, 0);
+                for (uint8_t plane = 0; plane < target.planes(); plane++)
+                {
+                    const uint8_t from = planes > 1 ? plane : 0;
+                    for (uint8_t y = 0; y < copy_height; y++)
+                        FrameBuffer::copy_bits(src + (from * height + y) * stride, 0, target.row(header.y + y, plane), header.x, copy_width);
+                }
+                if (direct)
+                {
+                    const uint32_t publish = this->scan_frames_.get_publishes() + 1;
+                    this->ingest_rects_[publish % INGEST_RECTS] = {publish, header.x, (uint8_t)header.y, copy_width, copy_height};
+                }
             }
 
-            int LedDisplayComponent::get_width_internal()
+            if (!direct)
+                this->geometry_.map(this->window_, this->scan_frames_.back());
+            this->scan_frames_.publish();
+            this->last_publish_ = millis();
+            return true;
+        }
+
+        void LedDisplayComponent::ingest_catch_up_()
+        {
+            // back() misses the frames published since it was last handed over. If they were all
+            // rectangles only those are copied from the newest frame, otherwise the whole frame is.
+            TripleBuffer &frames = this->scan_frames_;
+            const FrameBuffer &published = frames.published();
+            FrameBuffer &back = frames.back();
+            const uint32_t first = frames.get_back_publish() + 1;
+            const uint32_t last = frames.get_publishes();
+            bool whole = last - first + 1 > INGEST_RECTS;
+            for (uint32_t publish = first; publish <= last && !whole; publish++)
+                whole = this->ingest_rects_[publish % INGEST_RECTS].publish != publish;
+            if (whole)
             {
-                return this->num_chips_ * 8;
+                back = published;
+                return;
             }
+            for (uint32_t publish = first; publish <= last; publish++)
+            {
+                const IngestRect &rect = this->ingest_rects_[publish % INGEST_RECTS];
+                for (uint8_t plane = 0; plane < back.planes(); plane++)
+                {
+                    for (uint8_t y = rect.y; y < rect.y + rect.height; y++)
+                        FrameBuffer::copy_bits(published.row(y, plane), rect.x, back.row(y, plane), rect.x, rect.width);
+                }
+            }
+        }
+#endif
 
-            void HOT LedDisplayComponent::draw_absolute_pixel_internal(int x, int y, Color color)
+        void LedDisplayComponent::animation_step_(uint32_t now)
+        {
+            // Every frame builds on the one before, so a late loop() decodes the frames it missed
+            // to stay in step. After a stall of more than a whole loop it just carries on from here.
+            uint16_t frames = this->animation_ != nullptr ? this->animation_->get_frames() : 0;
+            while (this->animation_ != nullptr && now - this->animation_since_ >= this->animation_duration_)
             {
-                if (x + 1 > (int)this->led_displaybuffer_[0].size())
-                { // Extend the display buffer in case required
-                    for (int chip_line = 0; chip_line < this->num_chip_lines_; chip_line++)
-                    {
-                        this->led_displaybuffer_[chip_line].resize(x + 1, this->bckgrnd_);
-                    }
+                if (frames-- == 0)
+                {
+                    this->animation_since_ = now;
+                    break;
                 }
+                this->animation_since_ += this->animation_duration_;
+                this->animation_duration_ = this->animation_->next(this->animation_canvas_);
+                if (this->animation_duration_ == 0)
+                    this->animation_ = nullptr;
+                else
+                    this->frame_dirty_ = true;
+            }
+        }
+
+        void LedDisplayComponent::play_animation(Animation *animation)
+        {
+            this->animation_ = animation;
+            this->animation_duration_ = animation->restart(this->animation_canvas_);
+            this->animation_since_ = millis();
+            this->animation_active_ = true;
+            this->frame_dirty_ = true;
+        }
 
-                if ((y >= this->get_height_internal()) || (y < 0) || (x < 0)) // If pixel is outside display then dont draw
+        void LedDisplayComponent::stop_animation()
+        {
+            this->animation_ = nullptr;
+            this->animation_active_ = false;
+            this->frame_dirty_ = true;
+        }
+
+        void LedDisplayComponent::playlist_step_(uint32_t now)
+        {
+            const PlaylistEntry *entry = this->playlist_.get(this->playlist_index_);
+            const uint16_t visible = get_width_internal();
+            const uint16_t span = this->transition_span_(entry);
+
+            // The effects are a function of the time since the switch, not of the loop count
+            if (this->transition_step_ < span)
+            {
+                const uint16_t step = transition_progress(now - this->playlist_since_, entry->get_transition_time(), span);
+                if (step != this->transition_step_)
+                {
+                    this->transition_step_ = step;
+                    this->frame_dirty_ = true;
+                }
+                if (step < span)
                     return;
+                // scroll_delay starts once the message is fully in
+                this->last_scroll_ = this->playlist_since_ + entry->get_transition_time();
+            }
+
+            const bool dark = blink_dark(now - this->playlist_since_, entry->get_blink());
+            if (dark != this->blink_dark_)
+            {
+                this->blink_dark_ = dark;
+                this->frame_dirty_ = true;
+            }
+
+            const uint16_t offset = this->scroll_offset_;
+            const uint16_t speed = entry->get_scroll_speed() != 0 ? entry->get_scroll_speed() : this->scroll_speed_;
+            if (this->scroll_step_(now, entry->get_width(), entry->get_scroll(), entry->get_scroll_mode(), speed))
+                this->playlist_pass_done_ = true;
+
+            // Move on after the dwell time, but not before a scrolling message went all the way through
+            const bool scrolls = entry->get_scroll() && entry->get_width() > visible;
+            if ((now - this->playlist_since_ < entry->get_dwell()) || (scrolls && !this->playlist_pass_done_))
+                return;
+            this->playlist_show_((this->playlist_index_ + 1) % this->playlist_.size(), now, this->playlist_pass_done_ ? offset : this->scroll_offset_);
+        }
+
+        uint16_t LedDisplayComponent::transition_span_(const PlaylistEntry *entry)
+        {
+            const PlaylistTransition transition = entry->get_transition();
+            if (transition == TRANSITION_SCROLL_UP || transition == TRANSITION_SCROLL_DOWN)
+                return get_height_internal();
+            return get_width_internal();
+        }
+
+        void LedDisplayComponent::playlist_show_(size_t index, uint32_t now, uint16_t leaving_offset)
+        {
+            this->playlist_prev_ = this->playlist_index_;
+            this->playlist_prev_offset_ = leaving_offset;
+            this->playlist_index_ = index;
+            this->playlist_since_ = now;
+            this->playlist_pass_done_ = false;
+            this->scroll_offset_ = 0;
+            this->last_scroll_ = now;
+            this->blink_dark_ = false;
+            const PlaylistEntry *entry = this->playlist_.get(index);
+            this->transition_step_ = entry->get_transition() == TRANSITION_NONE ? this->transition_span_(entry) : 0;
+            this->frame_dirty_ = true;
+        }
+
+        PlaylistEntry *LedDisplayComponent::add_playlist_entry(const std::string &text, uint32_t dwell)
+        {
+            return this->playlist_.add(new PlaylistEntry(text, dwell));
+        }
+
+        PlaylistEntry *LedDisplayComponent::add_playlist_entry(playlist_source_t source, uint32_t dwell)
+        {
+            return this->playlist_.add(new PlaylistEntry(std::move(source), dwell));
+        }
+
+        void LedDisplayComponent::playlist_start()
+        {
+            if (this->playlist_.empty())
+            {
+                ESP_LOGW(TAG, "Playlist is empty");
+                return;
+            }
+            // The arena is only allocated for displays that use a playlist
+            if (!this->playlist_.ready())
+            {
+                const uint8_t planes = this->gray_scale_ ? BRIGHTNESS_BITS : 1;
+                this->playlist_.init(get_height_internal(), this->playlist_arena_width_, planes, this->font_);
+            }
+            this->playlist_.refresh();
+            this->playlist_active_ = true;
+            this->playlist_show_(0, millis(), 0);
+            this->transition_step_ = this->transition_span_(this->playlist_.get(0));
+        }
+
+        void LedDisplayComponent::playlist_stop()
+        {
+            this->playlist_active_ = false;
+            this->scroll_offset_ = 0;
+            this->last_scroll_ = millis();
+            this->frame_dirty_ = true;
+        }
 
-                uint16_t pos = x;   // X is starting at 0 top left
-                uint8_t subpos = y; // Y is starting at 0 top left
+        void LedDisplayComponent::playlist_next()
+        {
+            if (this->playlist_active_)
+                this->playlist_show_((this->playlist_index_ + 1) % this->playlist_.size(), millis(), this->scroll_offset_);
+        }
+
+        void LedDisplayComponent::display()
+        {
+            // Only copy the visible window, the scanner never sees the (resizing) draw buffer.
+            // It picks up the published frame at its next frame start, so frames never tear.
+            // With several tiles the window is composed first and then spread over the chain.
+            const uint16_t visible = get_width_internal();
+            FrameBuffer &target = this->geometry_.is_direct() ? this->scan_frames_.back() : this->window_;
+            for (uint8_t plane = 0; plane < target.planes(); plane++)
+            {
+                for (uint8_t line = 0; line < this->get_height_internal(); line++)
+                {
+                    uint32_t *dst = target.row(line, plane);
+                    if (this->animation_active_)
+                        this->animation_window_(line, plane, dst);
+                    else if (this->marquee_active_)
+                        this->marquee_.copy_window(line, plane, dst);
+                    else if (this->playlist_active_)
+                        this->playlist_window_(line, plane, dst);
+                    else
+                        this->copy_window_(this->buffer_.row(line, plane), 0, this->buffer_.width(), this->scroll_offset_, dst, 0, visible);
+                }
+            }
+            if (!this->geometry_.is_direct())
+                this->geometry_.map(this->window_, this->scan_frames_.back());
+            this->scan_frames_.publish();
+            this->last_publish_ = millis();
+            this->frame_dirty_ = false;
+        }
 
-                if (color.is_on())
+        void LedDisplayComponent::copy_window_(const uint32_t *src, uint16_t start, uint16_t content, uint16_t offset,
+                                               uint32_t *dst, uint16_t dst_column, uint16_t count)
+        {
+            // The viewport starts at `offset` on a canvas of the `content` columns from `start`
+            // followed by background gap columns, at least one and enough to fill the display,
+            // wrapping around. Cost only depends on `count`.
+            const uint16_t canvas = std::max<uint16_t>(content + 1, get_width_internal());
+            uint16_t pos = offset % canvas;
+            const uint16_t end = dst_column + count;
+            uint16_t done = dst_column;
+            while (done < end)
+            {
+                uint16_t n;
+                if (pos < content)
                 {
-                    this->led_displaybuffer_[subpos / 8][pos] |= (1 << subpos % 8);
+                    n = std::min<uint16_t>(end - done, content - pos);
+                    FrameBuffer::copy_bits(src, start + pos, dst, done, n);
                 }
                 else
                 {
-                    this->led_displaybuffer_[subpos / 8][pos] &= ~(1 << subpos % 8);
+                    n = std::min<uint16_t>(end - done, canvas - pos);
+                    FrameBuffer::set_bits(dst, done, n, this->bckgrnd_);
                 }
+                done += n;
+                pos = (pos + n) % canvas;
             }
+        }
 
-            void LedDisplayComponent::send_byte_(uint8_t a_register, uint8_t data)
+        void LedDisplayComponent::animation_window_(uint8_t line, uint8_t plane, uint32_t *dst)
+        {
+            // Top left aligned, cut off or padded with background to the display. An on/off
+            // animation is shown at full brightness on every plane.
+            const FrameBuffer &canvas = this->animation_canvas_;
+            if (line >= canvas.height())
             {
-                this->write_byte(a_register); // Write register value to MAX
-                this->write_byte(data);       // Followed by actual data
+                FrameBuffer::set_bits(dst, 0, get_width_internal(), this->bckgrnd_);
+                return;
             }
-            /*
-        void LedDisplayComponent::send_to_all_(uint8_t a_register, uint8_t data)
-        {
-            // this->enable();                                // Enable SPI
-            for (uint8_t i = 0; i < this->num_chips_; i++) // Run the loop for every MAX chip in the stack
-                this->send_byte_(a_register, data);        // Send the data to the chips
-                                                           // this->disable();                               // Disable SPI
+            const uint32_t *src = canvas.row(line, canvas.planes() > 1 ? std::min<uint8_t>(plane, canvas.planes() - 1) : 0);
+            this->copy_window_(src, 0, canvas.width(), 0, dst, 0, get_width_internal());
         }
-        */
-            void LedDisplayComponent::update()
+
+        void LedDisplayComponent::playlist_window_(uint8_t line, uint8_t plane, uint32_t *dst)
+        {
+            // Every effect is composed from whole-word copies out of the arena, whatever its progress
+            const FrameBuffer &arena = this->playlist_.arena();
+            const PlaylistEntry *entry = this->playlist_.get(this->playlist_index_);
+            const PlaylistEntry *prev = this->playlist_.get(this->playlist_prev_);
+            const uint16_t visible = get_width_internal();
+            const uint8_t height = get_height_internal();
+            const uint16_t span = this->transition_span_(entry);
+            const uint16_t in = std::min<uint16_t>(this->transition_step_, span);
+            const uint16_t out = span - in;
+
+            switch (out == 0 ? TRANSITION_NONE : entry->get_transition())
             {
-                this->update_ = true;
-                for (int chip_line = 0; chip_line < this->num_chip_lines_; chip_line++)
-                {
-                    this->led_displaybuffer_[chip_line].clear();
-                    this->led_displaybuffer_[chip_line].resize(get_width_internal(), this->bckgrnd_);
-                }
-                if (this->writer_local_.has_value()) // insert Labda function if available
-                    (*this->writer_local_)(*this);
+            case TRANSITION_WIPE:
+                this->copy_window_(arena.row(line, plane), entry->get_start(), entry->get_width(), 0, dst, 0, in);
+                this->copy_window_(arena.row(line, plane), prev->get_start(), prev->get_width(), this->playlist_prev_offset_ + in, dst, in, out);
+                break;
+            case TRANSITION_SLIDE:
+                this->copy_window_(arena.row(line, plane), prev->get_start(), prev->get_width(), this->playlist_prev_offset_ + in, dst, 0, out);
+                this->copy_window_(arena.row(line, plane), entry->get_start(), entry->get_width(), 0, dst, out, in);
+                break;
+            case TRANSITION_SCROLL_UP:
+                if (line + in < height)
+                    this->copy_window_(arena.row(line + in, plane), prev->get_start(), prev->get_width(), this->playlist_prev_offset_, dst, 0, visible);
+                else
+                    this->copy_window_(arena.row(line + in - height, plane), entry->get_start(), entry->get_width(), 0, dst, 0, visible);
+                break;
+            case TRANSITION_SCROLL_DOWN:
+                if (line < in)
+                    this->copy_window_(arena.row(line + out, plane), entry->get_start(), entry->get_width(), 0, dst, 0, visible);
+                else
+                    this->copy_window_(arena.row(line - in, plane), prev->get_start(), prev->get_width(), this->playlist_prev_offset_, dst, 0, visible);
+                break;
+            default:
+                if (this->blink_dark_)
+                    FrameBuffer::set_bits(dst, 0, visible, this->bckgrnd_);
+                else
+                    this->copy_window_(arena.row(line, plane), entry->get_start(), entry->get_width(), this->scroll_offset_, dst, 0, visible);
+                break;
             }
+        }
+
+        void LedDisplayComponent::scan_timer_callback_(void *arg)
+        {
+            auto *display = static_cast<LedDisplayComponent *>(arg);
+            uint32_t late = display->scan_timer_.get_lateness();
+            if (late > display->max_jitter_us_)
+                display->max_jitter_us_ = late;
+            display->jitter_histogram_.add(late);
+            display->scan_row_();
+        }
 
-            void LedDisplayComponent::invert_on_off(bool on_off) { this->invert_ = on_off; };
-            void LedDisplayComponent::invert_on_off() { this->invert_ = !this->invert_; };
+        void LedDisplayComponent::scan_row_()
+        {
+            if (!this->scan_powered_())
+                return;
 
-            void LedDisplayComponent::turn_on_off(bool on_off)
+            if (this->scan_frames_.front().planes() > 1 || this->brightness_ < MAX_BRIGHTNESS)
             {
-                /*
-            if (on_off)
+                this->scan_bcm_();
+                return;
+            }
+
+            if (this->row_lit_ && this->row_on_time_us_ < this->row_period_us_)
             {
-                this->send_to_all_(MAX7219_REGISTER_SHUTDOWN, 1);
+                // End of the on-time: keep the row dark for the rest of its slot
+                panel_pin_write(this->rows[this->scan_line_], false);
+                this->row_lit_ = false;
+                this->scan_timer_.release_latch();
+                this->scan_timer_.schedule_dark(this->row_period_us_ - this->row_on_time_us_);
+                return;
             }
-            else
+
+            // Shift the next row while the current one is still lit, the 74HC595 outputs
+            // only change on the latch so the dark time is just the latch pulse.
+            uint8_t next_line = (this->scan_line_ + 1) % this->geometry_.scan_rows();
+            if (next_line == 0)
+                this->scan_frame_start_();
+            if (!(this->scan_lit_rows_ & (1UL << next_line)))
             {
-                this->send_to_all_(MAX7219_REGISTER_SHUTDOWN, 0);
+                // Nothing to light: no shift and the row stays dark for its slot. A blank frame
+                // is slept through in one go.
+                if (this->row_lit_)
+                    panel_pin_write(this->rows[this->scan_line_], false);
+                this->row_lit_ = false;
+                this->scan_timer_.release_latch();
+                const uint8_t slots = this->scan_lit_rows_ == 0 ? this->geometry_.scan_rows() - next_line : 1;
+                this->scan_line_ = next_line + slots - 1;
+                this->scan_timer_.schedule_dark(this->row_period_us_ * slots);
+                return;
             }
-            */
+            this->shifts_++;
+            this->orient_transport_();
+            uint32_t shift_start = micros();
+            this->transport_->shift_row(this->scan_frames_.front().row(next_line), this->geometry_.chain_bits());
+            this->row_shift_time_us_ = micros() - shift_start;
+            if (this->row_lit_)
+                panel_pin_write(this->rows[this->scan_line_], false);
+            this->transport_->latch();
+            panel_pin_write(this->rows[next_line], true);
+
+            this->scan_line_ = next_line;
+            this->row_lit_ = true;
+            this->scan_timer_.hold_latch();
+            this->scan_timer_.schedule_next(this->row_on_time_us_);
+        }
+
+        void LedDisplayComponent::scan_bcm_()
+        {
+            // Binary code modulation: the row on-time is split in sub-frames of 1, 2, 4 and 8 units.
+            // Sub-frame b shows bit plane b (gray scale) or, for a single plane, is only lit when bit b
+            // of the brightness is set. Every tick either starts or ends the lit part of a sub-frame.
+            if (this->row_lit_)
+            {
+                panel_pin_write(this->rows[this->scan_line_], false);
+                this->row_lit_ = false;
+                this->scan_timer_.release_latch();
+                // the shift at the start of the sub-frame was not counted as lit time, take it from the dark part
+                uint32_t dark = this->subframe_time_(this->scan_bit_) - this->subframe_lit_time_(this->scan_bit_);
+                dark = dark > this->subframe_shift_us_ ? dark - this->subframe_shift_us_ : 0;
+                // advance only after the times of the sub-frame that ends were taken
+                const uint32_t tail = this->advance_subframe_();
+                this->scan_timer_.schedule_dark(dark + tail);
+                return;
             }
 
-            void LedDisplayComponent::scroll(bool on_off, ScrollMode mode, uint16_t speed, uint16_t delay, uint16_t dwell)
+            if (this->scan_bit_ == 0 && !(this->scan_lit_rows_ & (1UL << this->scan_line_)))
             {
-                this->set_scroll(on_off);
-                this->set_scroll_mode(mode);
-                this->set_scroll_speed(speed);
-                this->set_scroll_dwell(dwell);
-                this->set_scroll_delay(delay);
+                // Nothing to light in this row, sleep through all of its sub-frames. A blank frame
+                // is slept through in one go.
+                const uint8_t slots = this->scan_lit_rows_ == 0 ? this->geometry_.scan_rows() - this->scan_line_ : 1;
+                const uint32_t skipped = this->row_period_us_ * (slots - 1) + this->row_on_time_us_;
+                this->scan_line_ += slots - 1;
+                this->scan_bit_ = BRIGHTNESS_BITS - 1;
+                const uint32_t tail = this->advance_subframe_();
+                this->scan_timer_.schedule_dark(skipped + tail);
+                return;
             }
 
-            void LedDisplayComponent::scroll(bool on_off, ScrollMode mode)
+            const bool gray = this->scan_frames_.front().planes() > 1;
+            this->subframe_shift_us_ = 0;
+            if (this->scan_bit_ == 0 || gray)
             {
-                this->set_scroll(on_off);
-                this->set_scroll_mode(mode);
+                this->shifts_++;
+                this->orient_transport_();
+                uint32_t shift_start = micros();
+                this->transport_->shift_row(this->scan_frames_.front().row(this->scan_line_, gray ? this->scan_bit_ : 0), this->geometry_.chain_bits());
+                this->transport_->latch();
+                this->subframe_shift_us_ = micros() - shift_start;
+                this->row_shift_time_us_ = this->subframe_shift_us_;
             }
 
-            void LedDisplayComponent::scroll(bool on_off) { this->set_scroll(on_off); }
+            uint32_t lit = this->subframe_lit_time_(this->scan_bit_);
+            if (lit == 0)
+            {
+                const uint32_t dark = this->subframe_time_(this->scan_bit_);
+                const uint32_t tail = this->advance_subframe_();
+                this->scan_timer_.schedule_dark(dark + tail);
+                return;
+            }
+            panel_pin_write(this->rows[this->scan_line_], true);
+            this->row_lit_ = true;
+            this->scan_timer_.hold_latch();
+            // The short sub-frames are only a few shift times long, so time the lit part from here
+            this->scan_timer_.resync();
+            this->scan_timer_.schedule_next(lit);
+        }
+
+        uint32_t LedDisplayComponent::subframe_time_(uint8_t bit) const
+        {
+            return (this->row_on_time_us_ << bit) / MAX_BRIGHTNESS;
+        }
+
+        uint32_t LedDisplayComponent::subframe_lit_time_(uint8_t bit) const
+        {
+            // Gray scale already uses the sub-frames per pixel, global brightness scales every one of them
+            if (this->scan_frames_.front().planes() > 1)
+                return this->subframe_time_(bit) * this->brightness_ / MAX_BRIGHTNESS;
+            return ((this->brightness_ >> bit) & 1) ? this->subframe_time_(bit) : 0;
+        }
+
+        uint32_t LedDisplayComponent::advance_subframe_()
+        {
+            // Returns the dark tail of the row slot once its last sub-frame is done
+            if (++this->scan_bit_ < BRIGHTNESS_BITS)
+                return 0;
+            this->scan_bit_ = 0;
+            const uint32_t tail = this->row_period_us_ - this->row_on_time_us_;
+            this->scan_line_ = (this->scan_line_ + 1) % this->geometry_.scan_rows();
+            if (this->scan_line_ == 0)
+                this->scan_frame_start_();
+            return tail;
+        }
+
+        void LedDisplayComponent::scan_frame_start_()
+        {
+            this->frames_++;
+            if (this->scan_frames_.acquire())
+                this->scan_lit_rows_ = this->lit_rows_(this->scan_frames_.front());
+
+            const uint16_t rate = this->scan_rate_;
+            if (rate != this->applied_rate_ || get_scan_scheduler().get_panels() != this->applied_panels_)
+                this->apply_scan_rate_(rate);
+        }
 
-            void LedDisplayComponent::scroll_left()
+        void LedDisplayComponent::apply_scan_rate_(uint16_t rate)
+        {
+            // A new rate keeps the share of the row period that is lit, so the brightness stays the same.
+            // Panels take turns on the shared latch, each one lights a row for at most its share of the period.
+            const uint8_t panels = get_scan_scheduler().get_panels();
+            this->applied_rate_ = rate;
+            this->applied_panels_ = panels;
+            this->row_period_us_ = 1000000UL / (rate * this->geometry_.scan_rows());
+            this->row_on_time_us_ = (uint64_t)this->base_row_on_time_us_ * this->row_period_us_ / this->base_row_period_us_;
+            if (panels > 1)
+                this->row_on_time_us_ = std::min(this->row_on_time_us_, this->row_period_us_ / panels);
+        }
+
+        uint32_t LedDisplayComponent::lit_rows_(const FrameBuffer &frame) const
+        {
+            // Inverted, a blank row has every column lit
+            if (!this->skip_blank_rows_ || this->invert_.load(std::memory_order_relaxed))
+                return 0xFFFFFFFFUL;
+            uint32_t lit = 0;
+            for (uint8_t plane = 0; plane < frame.planes(); plane++)
             {
-                for (int chip_line = 0; chip_line < this->num_chip_lines_; chip_line++)
+                for (uint8_t y = 0; y < frame.height(); y++)
                 {
-                    if (this->update_)
+                    const uint32_t *row = frame.row(y, plane);
+                    for (uint16_t i = 0; i < frame.stride(); i++)
                     {
-                        this->led_displaybuffer_[chip_line].push_back(this->bckgrnd_);
-                        for (uint16_t i = 0; i < this->stepsleft_; i++)
+                        if (row[i] != 0)
                         {
-                            this->led_displaybuffer_[chip_line].push_back(this->led_displaybuffer_[chip_line].front());
-                            this->led_displaybuffer_[chip_line].erase(this->led_displaybuffer_[chip_line].begin());
+                            lit |= 1UL << y;
+                            break;
                         }
                     }
-                    else
-                    {
-                        this->led_displaybuffer_[chip_line].push_back(this->led_displaybuffer_[chip_line].front());
-                        this->led_displaybuffer_[chip_line].erase(this->led_displaybuffer_[chip_line].begin());
-                    }
                 }
-                this->update_ = false;
-                this->stepsleft_++;
             }
+            return lit;
+        }
+
+        bool LedDisplayComponent::scan_powered_()
+        {
+            if (this->scan_state_ != SCAN_STOPPING)
+                return true;
+
+            // Turned off: every row dark, the shift register cleared and latched when no other panel
+            // uses it, and the timer is not armed again. From here on the main loop owns the scan
+            // until it is turned on.
+            for (auto row : this->rows)
+                panel_pin_write(row, false);
+            // The other panels' chains would be cleared too, dark rows are enough for those
+            if (get_scan_scheduler().get_panels() == 1)
+            {
+                panel_pin_write(MasterClr, false);
+                this->transport_->latch();
+            }
+            this->row_lit_ = false;
+            this->scan_timer_.release_latch();
+            this->scan_bit_ = 0;
+            this->scan_line_ = this->geometry_.scan_rows() - 1;
+            uint8_t state = SCAN_STOPPING;
+            if (this->scan_state_.compare_exchange_strong(state, SCAN_STOPPED))
+                return false;
+            // turned on again in the meantime
+            panel_pin_write(MasterClr, true);
+            return true;
+        }
+
+        float LedDisplayComponent::led_duty_() const
+        {
+            // Share of the pixel time the LEDs are lit: content times on-time times brightness
+            if (!this->is_on())
+                return 0;
+            const FrameBuffer &frame = this->scan_frames_.published();
+            uint32_t lit = 0;
+            for (uint8_t plane = 0; plane < frame.planes(); plane++)
+            {
+                // a single plane is full brightness, gray scale plane b weighs 2^b
+                const uint8_t weight = frame.planes() > 1 ? 1 << plane : MAX_BRIGHTNESS;
+                for (uint8_t y = 0; y < frame.height(); y++)
+                {
+                    for (uint16_t i = 0; i < frame.stride(); i++)
+                        lit += __builtin_popcount(frame.row(y, plane)[i]) * weight;
+                }
+            }
+            const float content = (float)lit / ((uint32_t)frame.height() * frame.width() * MAX_BRIGHTNESS);
+            const float on_time = (float)this->base_row_on_time_us_ / this->base_row_period_us_;
+            return content * on_time * this->brightness_ / MAX_BRIGHTNESS;
+        }
+
+        int LedDisplayComponent::get_height_internal()
+        {
+            return this->num_chip_lines_ * this->geometry_.tiles_y();
+        }
+
+        int LedDisplayComponent::get_width_internal()
+        {
+            return this->num_chips_ * 8 * this->geometry_.tiles_x();
+        }
+
+        void HOT LedDisplayComponent::draw_absolute_pixel_internal(int x, int y, Color color)
+        {
+            if ((y >= this->get_height_internal()) || (y < 0) || (x < 0)) // If pixel is outside display then dont draw
+                return;
+
+            if (x >= this->buffer_.capacity())
+                return;
+
+            this->draw_other_();
+            if (x + 1 > this->buffer_.width()) // Extend the used part of the canvas in case required
+                this->buffer_.resize(x + 1, this->bckgrnd_);
+
+            // X and Y are starting at 0 top left
+            this->buffer_.set_level(x, y, this->color_level_(color));
+        }
+
+        uint8_t LedDisplayComponent::color_level_(Color color) const
+        {
+            if (this->gray_scale_)
+                return std::max({color.red, color.green, color.blue, color.white}) >> (8 - BRIGHTNESS_BITS);
+            return color.is_on() ? 0xFF : 0;
+        }
+
+        bool LedDisplayComponent::clip_span_(int &x, int &y, int &width, int &height)
+        {
+            // Clip to the canvas and extend its used part, like draw_absolute_pixel_internal does
+            this->draw_other_();
+            if (x < 0)
+            {
+                width += x;
+                x = 0;
+            }
+            if (y < 0)
+            {
+                height += y;
+                y = 0;
+            }
+            width = std::min(width, (int)this->buffer_.capacity() - x);
+            height = std::min(height, this->get_height_internal() - y);
+            if (width <= 0 || height <= 0)
+                return false;
+            if (x + width > this->buffer_.width())
+                this->buffer_.resize(x + width, this->bckgrnd_);
+            return true;
+        }
+
+        void LedDisplayComponent::fill(Color color)
+        {
+            this->draw_other_();
+            this->buffer_.fill_rect(0, 0, this->buffer_.width(), this->get_height_internal(), this->color_level_(color));
+        }
+
+        void LedDisplayComponent::horizontal_line(int x, int y, int width, Color color)
+        {
+            this->filled_rectangle(x, y, width, 1, color);
+        }
 
-            void LedDisplayComponent::send_char(uint8_t chip, uint8_t data)
+        void LedDisplayComponent::vertical_line(int x, int y, int height, Color color)
+        {
+            this->filled_rectangle(x, y, 1, height, color);
+        }
+
+        void LedDisplayComponent::filled_rectangle(int x1, int y1, int width, int height, Color color)
+        {
+            if (this->rotation_ != display::DISPLAY_ROTATION_0_DEGREES)
             {
-                // get this character from PROGMEM
-                for (uint8_t i = 0; i < 8; i++)
-                    this->led_displaybuffer_[0][chip * 8 + i] = progmem_read_byte(&MAX7219_DOT_MATRIX_FONT[data][i]);
-            } // end of send_char
+                display::DisplayBuffer::filled_rectangle(x1, y1, width, height, color);
+                return;
+            }
+            if (this->clip_span_(x1, y1, width, height))
+                this->buffer_.fill_rect(x1, y1, width, height, this->color_level_(color));
+        }
 
-            // send one character (data) to position (chip)
+        void LedDisplayComponent::image(int x, int y, display::Image *image, Color color_on, Color color_off)
+        {
+            if (this->rotation_ != display::DISPLAY_ROTATION_0_DEGREES || image->get_type() != display::IMAGE_TYPE_BINARY)
+            {
+                display::DisplayBuffer::image(x, y, image, color_on, color_off);
+                return;
+            }
+            int left = x;
+            int top = y;
+            int width = image->get_width();
+            int height = image->get_height();
+            if (!this->clip_span_(left, top, width, height))
+                return;
 
-            void LedDisplayComponent::send64pixels(uint8_t chip, const uint8_t pixels[8])
+            // Gather up to a word of image pixels, then write it to every plane in one go
+            const uint8_t on = this->color_level_(color_on);
+            const uint8_t off = this->color_level_(color_off);
+            for (int row = 0; row < height; row++)
             {
-                for (uint8_t col = 0; col < 8; col++)
-                {                                      // RUN THIS LOOP 8 times until column is 7
-                                                       // this->enable();                    // start sending by enabling SPI
-                    for (uint8_t i = 0; i < chip; i++) // send extra NOPs to push the pixels out to extra displays
-                        this->send_byte_(MAX7219_REGISTER_NOOP,
-                                         MAX7219_REGISTER_NOOP); // run this loop unit the matching chip is reached
-                    uint8_t b = 0;                               // rotate pixels 90 degrees -- set byte to 0
-                    if (this->orientation_ == 0)
-                    {
-                        for (uint8_t i = 0; i < 8; i++)
-                        {
-                            // run this loop 8 times for all the pixels[8] received
-                            b |= ((pixels[i] >> col) & 1) << (7 - i); // change the column bits into row bits
-                        }
-                    }
-                    else if (this->orientation_ == 1)
-                    {
-                        b = pixels[col];
-                    }
-                    else if (this->orientation_ == 2)
-                    {
-                        for (uint8_t i = 0; i < 8; i++)
-                        {
-                            b |= ((pixels[i] >> (7 - col)) & 1) << i;
-                        }
-                    }
-                    else
-                    {
-                        b = pixels[7 - col];
-                    }
-                    // send this byte to display at selected chip
-                    if (this->invert_)
+                for (int col = 0; col < width; col += FrameBuffer::WORD_BITS)
+                {
+                    const int count = std::min<int>(FrameBuffer::WORD_BITS, width - col);
+                    uint32_t word = 0;
+                    for (int i = 0; i < count; i++)
                     {
-                        this->send_byte_(col + 1, ~b);
+                        if (image->get_pixel(left - x + col + i, top - y + row))
+                            word |= 1UL << i;
                     }
-                    else
+                    for (uint8_t plane = 0; plane < this->buffer_.planes(); plane++)
                     {
-                        this->send_byte_(col + 1, b);
+                        uint32_t bits = (((on >> plane) & 1) ? word : 0) | (((off >> plane) & 1) ? ~word : 0);
+                        FrameBuffer::copy_bits(&bits, 0, this->buffer_.row(top + row, plane), left + col, count);
                     }
-                    for (int i = 0; i < this->num_chips_ - chip - 1; i++) // end with enough NOPs so later chips don't update
-                        this->send_byte_(MAX7219_REGISTER_NOOP, MAX7219_REGISTER_NOOP);
-                    // this->disable(); // all done disable SPI
-                } // end of for each column
-            }     // end of send64pixels
-
-            uint8_t LedDisplayComponent::printdigit(const char *str) { return this->printdigit(0, str); }
-
-            uint8_t LedDisplayComponent::printdigit(uint8_t start_pos, const char *s)
-            {
-                uint8_t chip = start_pos;
-                for (; chip < this->num_chips_ && *s; chip++)
-                    send_char(chip, *s++);
-                // space out rest
-                while (chip < (this->num_chips_))
-                    send_char(chip++, ' ');
-                return 0;
-            } // end of sendString
+                }
+            }
+        }
 
-            uint8_t LedDisplayComponent::printdigitf(uint8_t pos, const char *format, ...)
+        void LedDisplayComponent::update()
+        {
+            uint32_t start = micros();
+            if (this->playlist_active_)
             {
-                va_list arg;
-                va_start(arg, format);
-                char buffer[64];
-                int ret = vsnprintf(buffer, sizeof(buffer), format, arg);
-                va_end(arg);
-                if (ret > 0)
-                    return this->printdigit(pos, buffer);
-                return 0;
+                // The messages are already rendered, only text that changed is laid out again
+                if (this->playlist_.refresh())
+                    this->frame_dirty_ = true;
             }
-            uint8_t LedDisplayComponent::printdigitf(const char *format, ...)
+            else
             {
-                va_list arg;
-                va_start(arg, format);
-                char buffer[64];
-                int ret = vsnprintf(buffer, sizeof(buffer), format, arg);
-                va_end(arg);
-                if (ret > 0)
-                    return this->printdigit(buffer);
-                return 0;
+                this->draw_writer_();
             }
+            this->update_us_ = micros() - start;
 
-#ifdef USE_TIME
-            uint8_t LedDisplayComponent::strftimedigit(uint8_t pos, const char *format, time::ESPTime time)
+            this->publish_stats_();
+        }
+
+        void LedDisplayComponent::draw_writer_()
+        {
+            const uint16_t old_width = this->buffer_.width();
+            const uint32_t old_hash = this->content_hash_;
+
+            // A frame drawn by text calls only is kept, the next one redraws just the glyphs that changed
+            this->text_retained_ = this->text_cache_.begin_frame();
+            this->text_changed_ = false;
+            if (!this->text_retained_)
             {
-                char buffer[64];
-                size_t ret = time.strftime(buffer, sizeof(buffer), format);
-                if (ret > 0)
-                    return this->printdigit(pos, buffer);
-                return 0;
+                this->buffer_.resize(get_width_internal());
+                this->buffer_.fill(this->bckgrnd_);
+            }
+            if (this->writer_local_.has_value()) // insert Labda function if available
+                (*this->writer_local_)(*this);
+
+            if (this->text_retained_)
+            {
+                const uint16_t width = std::max<uint16_t>(get_width_internal(), this->text_cache_.extent());
+                if (!this->text_cache_.complete()) // a call of the previous frame was not made again
+                    this->drop_retained_text_();
+                else if (width != this->buffer_.width())
+                    this->buffer_.resize(width, this->bckgrnd_);
+            }
+
+            // Same layout keeps the scroll position, only a new width restarts the text
+            if (!this->text_retained_ || this->text_changed_ || this->buffer_.width() != old_width)
+                this->content_hash_ = this->buffer_.hash();
+            this->text_retained_ = false;
+            if (this->buffer_.width() != old_width)
+            {
+                this->scroll_offset_ = 0;
+                this->last_scroll_ = millis();
+                this->frame_dirty_ = true;
+            }
+            else if (this->content_hash_ != old_hash)
+            {
+                this->frame_dirty_ = true;
+            }
+        }
+
+        void LedDisplayComponent::publish_stats_()
+        {
+            // The scanner only ever increments its counters, deltas are taken here on the main loop
+            uint32_t now = millis();
+            uint32_t frames = this->frames_;
+            uint32_t missed = this->scan_timer_.get_missed();
+            uint32_t shifts = this->shifts_;
+#ifdef USE_LED_DISPLAY_INGEST
+            uint32_t dropped = this->ingest_.get_dropped();
+            uint32_t late = this->ingest_.get_late();
+#else
+            uint32_t dropped = 0;
+            uint32_t late = 0;
+#endif
+            // a maximum the scanner raises between the read and the reset is kept for the next period
+            uint32_t max_jitter = this->max_jitter_us_.exchange(0);
+            uint32_t elapsed = now - this->stats_last_ms_;
+#ifdef USE_SENSOR
+            if (this->frame_rate_sensor_ != nullptr && elapsed > 0)
+                this->frame_rate_sensor_->publish_state((frames - this->stats_frames_) * 1000.0f / elapsed);
+            if (this->row_jitter_sensor_ != nullptr)
+                this->row_jitter_sensor_->publish_state(max_jitter);
+            if (this->loop_time_sensor_ != nullptr)
+                this->loop_time_sensor_->publish_state(this->max_loop_us_);
+            if (this->update_time_sensor_ != nullptr)
+                this->update_time_sensor_->publish_state(this->update_us_);
+            if (this->missed_deadlines_sensor_ != nullptr)
+                this->missed_deadlines_sensor_->publish_state(missed - this->stats_missed_);
+            if (this->dropped_frames_sensor_ != nullptr)
+                this->dropped_frames_sensor_->publish_state(dropped - this->stats_dropped_);
+            if (this->late_frames_sensor_ != nullptr)
+                this->late_frames_sensor_->publish_state(late - this->stats_late_);
+            if (this->scan_saved_sensor_ != nullptr && elapsed > 0)
+            {
+                // Row shifts a full rate scan of every row would have done in the same time
+                const float full = (float)this->refresh_rate_ * this->geometry_.scan_rows() *
+                                   (this->gray_scale_ ? BRIGHTNESS_BITS : 1) * elapsed / 1000.0f;
+                this->scan_saved_sensor_->publish_state(std::max(0.0f, 100.0f * (1.0f - (shifts - this->stats_shifts_) / full)));
+            }
+            if (this->led_duty_sensor_ != nullptr)
+                this->led_duty_sensor_->publish_state(100.0f * this->led_duty_());
+#endif
+            this->stats_last_ms_ = now;
+            this->stats_frames_ = frames;
+            this->stats_missed_ = missed;
+            this->stats_dropped_ = dropped;
+            this->stats_late_ = late;
+            this->stats_shifts_ = shifts;
+            this->max_loop_us_ = 0;
+        }
+
+        void LedDisplayComponent::invert_on_off(bool on_off)
+        {
+            // The scanner hands it to the transport with the next row
+            this->invert_.store(on_off, std::memory_order_relaxed);
+        }
+        void LedDisplayComponent::invert_on_off() { this->invert_on_off(!this->invert_.load(std::memory_order_relaxed)); }
+
+        void LedDisplayComponent::turn_on_off(bool on_off)
+        {
+            uint8_t state = on_off ? SCAN_STOPPING : SCAN_RUNNING;
+            if (!on_off)
+            {
+                // The scanner blanks the panel and stops itself at its next tick
+                this->scan_state_.compare_exchange_strong(state, SCAN_STOPPING);
+                return;
+            }
+            // Still stopping: the scanner just carries on
+            if (this->scan_state_.compare_exchange_strong(state, SCAN_RUNNING))
+                return;
+            state = SCAN_STOPPED;
+            if (this->scan_state_.compare_exchange_strong(state, SCAN_RUNNING))
+            {
+                // The scanner is idle, start it again from the top row
+                panel_pin_write(MasterClr, true);
+                this->scan_timer_.resync();
+                this->scan_timer_.schedule_next(0);
+            }
+        }
+
+        void LedDisplayComponent::scroll(bool on_off, ScrollMode mode, uint16_t speed, uint16_t delay, uint16_t dwell)
+        {
+            this->set_scroll(on_off);
+            this->set_scroll_mode(mode);
+            this->set_scroll_speed(speed);
+            this->set_scroll_dwell(dwell);
+            this->set_scroll_delay(delay);
+        }
+
+        void LedDisplayComponent::scroll(bool on_off, ScrollMode mode)
+        {
+            this->set_scroll(on_off);
+            this->set_scroll_mode(mode);
+        }
+
+        void LedDisplayComponent::scroll(bool on_off) { this->set_scroll(on_off); }
+
+        void LedDisplayComponent::intensity(uint8_t intensity)
+        {
+            // picked up by the scanner on its next sub-frame
+            this->brightness_ = std::min<uint8_t>(intensity, MAX_BRIGHTNESS);
+        }
+
+        void LedDisplayComponent::scroll_left()
+        {
+            const uint32_t now = millis();
+            const uint16_t content = this->buffer_.width();
+            if (this->scroll_)
+            {
+                // Start the pass one step earlier, so the timeline itself is a column further along.
+                // A pass that is still in its delay starts moving.
+                const uint32_t elapsed = std::max<uint32_t>(now - this->last_scroll_, this->scroll_delay_) + this->scroll_speed_;
+                this->last_scroll_ = now - elapsed;
+                this->scroll_step_(now, content, true, this->scroll_mode_, this->scroll_speed_);
+                return;
+            }
+            // Move the viewport instead of the pixels, the canvas is the content plus one gap column
+            this->scroll_offset_ = (this->scroll_offset_ + 1) % (content + 1);
+            this->frame_dirty_ = true;
+        }
+
+        void LedDisplayComponent::send_char(uint8_t chip, uint8_t data)
+        {
+            // one character per chip: blank the 8 columns, then draw the glyph at the left of them
+            this->draw_other_();
+            this->buffer_.fill_columns(chip * 8, 8, this->bckgrnd_);
+            this->draw_glyph_(chip * 8, data);
+        } // end of send_char
+
+        uint16_t LedDisplayComponent::draw_glyph_(uint16_t x, char c)
+        {
+            const Glyph &glyph = this->font_->get(c);
+            const uint16_t end = x + glyph.width + this->font_->spacing;
+            if (end > this->buffer_.width()) // Extend the used part of the canvas so long text scrolls
+                this->buffer_.resize(end, this->bckgrnd_);
+            if (x >= this->buffer_.width())
+                return end;
+
+            // one masked word write per row, the spacing columns are cleared with it
+            const uint16_t count = std::min<uint16_t>(end, this->buffer_.width()) - x;
+            const uint8_t height = std::min<uint8_t>(this->get_height_internal(), GLYPH_HEIGHT);
+            for (uint8_t y = 0; y < height; y++)
+            {
+                uint32_t bits = glyph.rows[y];
+                this->buffer_.write_bits(y, x, &bits, count);
+            }
+            return end;
+        }
+
+        // send an 8x8 block of pixels, one byte per row with the leftmost pixel in the MSB, to position (chip)
+        void LedDisplayComponent::send64pixels(uint8_t chip, const uint8_t pixels[8])
+        {
+            this->draw_other_();
+            for (uint8_t y = 0; y < this->get_height_internal() && y < 8; y++)
+            {
+                for (uint8_t col = 0; col < 8; col++)
+                    this->buffer_.set(chip * 8 + col, y, (pixels[y] >> (7 - col)) & 1);
+            }
+        } // end of send64pixels
+
+        uint8_t LedDisplayComponent::printdigit(const char *str) { return this->printdigit(0, str); }
+
+        uint8_t LedDisplayComponent::printdigit(uint8_t start_pos, const char *s)
+        {
+            const TextCache::Cell *previous = nullptr;
+            if (this->text_retained_)
+            {
+                // Diff against the same call of the previous frame. Calls must run left to right
+                // without overlapping, as each one blanks everything to its right.
+                const size_t index = this->text_cache_.size();
+                previous = this->text_cache_.previous(start_pos);
+                if (previous == nullptr || (index > 0 && start_pos < this->text_cache_.get(index - 1).end))
+                {
+                    this->drop_retained_text_();
+                    previous = nullptr;
+                }
+            }
+            uint8_t count = 0;
+            const uint16_t end = previous != nullptr ? this->redraw_text_(start_pos, s, *previous, count)
+                                                     : this->draw_text_(start_pos, s, count);
+            this->text_cache_.add(start_pos, end, s);
+            return count;
+        } // end of sendString
+
+        uint16_t LedDisplayComponent::draw_text_(uint16_t x, const char *s, uint8_t &count)
+        {
+            for (; *s && x < this->buffer_.capacity(); s++, count++)
+                x = this->draw_glyph_(x, *s);
+            const uint16_t end = x;
+            // space out rest
+            const uint16_t width = get_width_internal();
+            if (x < width)
+                this->buffer_.fill_columns(x, width - x, this->bckgrnd_);
+            return end;
+        }
+
+        uint16_t LedDisplayComponent::redraw_text_(uint16_t x, const char *s, const TextCache::Cell &previous, uint8_t &count)
+        {
+            // The previous frame left its glyphs in place, only draw those that differ in character or column
+            const char *old = previous.text.c_str();
+            uint16_t old_x = x;
+            for (; *s && x < this->buffer_.capacity(); s++, count++)
+            {
+                if (*old != 0 && *old == *s && old_x == x)
+                {
+                    x += this->font_->get(*s).width + this->font_->spacing;
+                }
+                else
+                {
+                    x = this->draw_glyph_(x, *s);
+                    this->text_changed_ = true;
+                }
+                if (*old != 0)
+                    old_x += this->font_->get(*old++).width + this->font_->spacing;
+            }
+            // The rest up to the display width is still blank, except where the old text was longer
+            const uint16_t old_end = std::min(previous.end, this->buffer_.width());
+            if (x < old_end)
+            {
+                this->buffer_.fill_columns(x, old_end - x, this->bckgrnd_);
+                this->text_changed_ = true;
             }
-            uint8_t LedDisplayComponent::strftimedigit(const char *format, time::ESPTime time)
+            return x;
+        }
+
+        void LedDisplayComponent::drop_retained_text_()
+        {
+            // The previous frame can not be kept after all, start from a blank canvas and replay this frame's text
+            this->text_retained_ = false;
+            this->text_changed_ = true;
+            this->buffer_.resize(get_width_internal());
+            this->buffer_.fill(this->bckgrnd_);
+            for (size_t i = 0; i < this->text_cache_.size(); i++)
             {
-                return this->strftimedigit(0, format, time);
+                const TextCache::Cell &cell = this->text_cache_.get(i);
+                uint8_t count = 0;
+                this->draw_text_(cell.x, cell.text.c_str(), count);
             }
+        }
+
+        uint8_t LedDisplayComponent::printdigitf(uint8_t pos, const char *format, ...)
+        {
+            va_list arg;
+            va_start(arg, format);
+            int ret = vsnprintf(this->text_format_.data(), this->text_format_.size(), format, arg);
+            va_end(arg);
+            if (ret > 0)
+                return this->printdigit(pos, this->text_format_.data());
+            return 0;
+        }
+        uint8_t LedDisplayComponent::printdigitf(const char *format, ...)
+        {
+            va_list arg;
+            va_start(arg, format);
+            int ret = vsnprintf(this->text_format_.data(), this->text_format_.size(), format, arg);
+            va_end(arg);
+            if (ret > 0)
+                return this->printdigit(this->text_format_.data());
+            return 0;
+        }
+
+#ifdef USE_TIME
+        uint8_t LedDisplayComponent::strftimedigit(uint8_t pos, const char *format, time::ESPTime time)
+        {
+            size_t ret = time.strftime(this->text_format_.data(), this->text_format_.size(), format);
+            if (ret > 0)
+                return this->printdigit(pos, this->text_format_.data());
+            return 0;
+        }
+        uint8_t LedDisplayComponent::strftimedigit(const char *format, time::ESPTime time)
+        {
+            return this->strftimedigit(0, format, time);
+        }
 #endif
 
-        } // namespace LedDisplay_ns
-    }     // namespace esphome
+    } // namespace LedDisplay_ns
+}     // namespace esphome
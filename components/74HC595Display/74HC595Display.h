@@ -4,6 +4,27 @@
 #include "esphome/core/hal.h"
 #include "esphome/core/defines.h"
 #include "esphome/components/display/display_buffer.h"
+#ifdef USE_SENSOR
+#include "esphome/components/sensor/sensor.h"
+#endif
+#include "animation.h"
+#include "font.h"
+#include "framebuffer.h"
+#include "geometry.h"
+#include "histogram.h"
+#include "ingest.h"
+#include "marquee.h"
+#include "output_transport.h"
+#include "panel_pins.h"
+#include "playlist.h"
+#include "scan_scheduler.h"
+#include "scan_timer.h"
+#include "scroll_mode.h"
+#include "text_cache.h"
+#include "timeline.h"
+#include "triple_buffer.h"
+
+#include <atomic>
 
 #ifdef USE_TIME
 #include "esphome/components/time/real_time_clock.h"
@@ -14,14 +35,18 @@ namespace esphome
     namespace LedDisplay_ns
     {
 
-        enum ScrollMode
+        class LedDisplayComponent;
+
+        static const uint8_t BRIGHTNESS_BITS = 4;
+        static const uint8_t MAX_BRIGHTNESS = (1 << BRIGHTNESS_BITS) - 1;
+
+        enum ScanState : uint8_t
         {
-            CONTINUOUS = 0,
-            STOP,
+            SCAN_RUNNING = 0,
+            SCAN_STOPPING, // turned off, the scanner blanks the panel and stops at its next tick
+            SCAN_STOPPED,
         };
 
-        class LedDisplayComponent;
-
         using ledDisplay_writer_t = std::function<void(LedDisplayComponent &)>;
 
         class LedDisplayComponent : public PollingComponent,
@@ -36,52 +61,150 @@ namespace esphome
 
             void dump_config() override;
 
+            void on_shutdown() override;
+
             void update() override;
 
             float get_setup_priority() const override;
 
+            /// Hand the visible part of the buffer to the background row scanner.
             void display();
 
             void invert_on_off(bool on_off);
             void invert_on_off();
 
+            /// Switch the panel off (blanked, scan stopped) or back on.
             void turn_on_off(bool on_off);
+            bool is_on() const { return this->scan_state_ != SCAN_STOPPED && this->scan_state_ != SCAN_STOPPING; }
 
             void draw_absolute_pixel_internal(int x, int y, Color color) override;
+
+            // Span based versions of the DisplayBuffer drawing calls, writing whole framebuffer
+            // words instead of going through draw_absolute_pixel_internal for every pixel.
+            void fill(Color color) override;
+            void horizontal_line(int x, int y, int width, Color color = COLOR_ON);
+            void vertical_line(int x, int y, int height, Color color = COLOR_ON);
+            void filled_rectangle(int x1, int y1, int width, int height, Color color = COLOR_ON);
+            void image(int x, int y, display::Image *image, Color color_on = COLOR_ON, Color color_off = COLOR_OFF);
+
             int get_height_internal() override;
             int get_width_internal() override;
 
             void set_num_chips(uint8_t num_chips) { this->num_chips_ = num_chips; };
             void set_num_chip_lines(uint8_t num_chip_lines) { this->num_chip_lines_ = num_chip_lines; };
+            void set_max_width(uint16_t max_width) { this->max_width_ = max_width; };
 
             void set_scroll_speed(uint16_t speed) { this->scroll_speed_ = speed; };
             void set_scroll_dwell(uint16_t dwell) { this->scroll_dwell_ = dwell; };
             void set_scroll_delay(uint16_t delay) { this->scroll_delay_ = delay; };
             void set_scroll(bool on_off) { this->scroll_ = on_off; };
             void set_scroll_mode(ScrollMode mode) { this->scroll_mode_ = mode; };
+            /// Shift the last column first, for panels whose chain runs from right to left.
             void set_reverse(bool on_off) { this->reverse_ = on_off; };
+            /// Drive the row pins bottom to top.
+            void set_flip_rows(bool flip_rows) { this->flipped_ = flip_rows; };
+            /// Row driver pins, top row first.
+            void set_row_pins(const std::vector<uint8_t> &pins)
+            {
+                this->rows.clear();
+                for (auto pin : pins)
+                    this->rows.push_back((gpio_num_t)pin);
+            };
+            /// Combine `tiles_x` x `tiles_y` panels of num_chips x num_chip_lines into one display.
+            void set_tiles(uint8_t tiles_x, uint8_t tiles_y) { this->geometry_.set_tiles(tiles_x, tiles_y); };
+            /// Tile indexes (row by row from the top left) in the order they are chained, first tile first.
+            void set_chain_order(const std::vector<uint8_t> &order) { this->geometry_.set_chain_order(order); };
+            void set_font(TextFont font)
+            {
+                this->font_type_ = font;
+                this->font_ = &get_font(font);
+                this->marquee_.set_font(this->font_);
+                this->playlist_.set_font(this->font_);
+                this->text_cache_.clear();
+            };
+            void set_refresh_rate(uint16_t refresh_rate) { this->refresh_rate_ = refresh_rate; };
+            void set_row_on_time(uint32_t row_on_time) { this->row_on_time_us_ = row_on_time; };
+            /// Scan at this rate once nothing was published for `idle_after` ms, 0 always scans at refresh_rate.
+            void set_idle_refresh_rate(uint16_t idle_refresh_rate) { this->idle_refresh_rate_ = idle_refresh_rate; };
+            void set_idle_after(uint32_t idle_after) { this->idle_after_ = idle_after; };
+            /// Do not shift or light rows without a lit pixel.
+            void set_skip_blank_rows(bool skip_blank_rows) { this->skip_blank_rows_ = skip_blank_rows; };
+            void set_intensity(uint8_t intensity) { this->intensity(intensity); };
+            void set_gray_scale(bool gray_scale) { this->gray_scale_ = gray_scale; };
+            void set_transport(OutputTransportType transport) { this->transport_type_ = transport; };
+            void set_data_rate(uint32_t data_rate) { this->data_rate_ = data_rate; };
+            /// Scan from a task on the other core (a thread on host builds) instead of the timer task.
+            /// All panels are scanned together, the first panel set up decides.
+            void set_scan_task(bool scan_task) { this->scan_task_ = scan_task; };
+            void set_playlist_arena_width(uint16_t width) { this->playlist_arena_width_ = width; };
+#ifdef USE_LED_DISPLAY_INGEST
+            /// Show raw frames received on this UDP port, see IngestHeader. 0 disables.
+            void set_ingest_port(uint16_t port) { this->ingest_port_ = port; };
+            /// Go back to the drawn content after this long without a frame.
+            void set_ingest_timeout(uint32_t timeout) { this->ingest_timeout_ = timeout; };
+#endif
+#ifdef USE_SENSOR
+            void set_frame_rate_sensor(sensor::Sensor *sensor) { this->frame_rate_sensor_ = sensor; };
+            void set_row_jitter_sensor(sensor::Sensor *sensor) { this->row_jitter_sensor_ = sensor; };
+            void set_loop_time_sensor(sensor::Sensor *sensor) { this->loop_time_sensor_ = sensor; };
+            void set_update_time_sensor(sensor::Sensor *sensor) { this->update_time_sensor_ = sensor; };
+            void set_missed_deadlines_sensor(sensor::Sensor *sensor) { this->missed_deadlines_sensor_ = sensor; };
+            void set_dropped_frames_sensor(sensor::Sensor *sensor) { this->dropped_frames_sensor_ = sensor; };
+            void set_late_frames_sensor(sensor::Sensor *sensor) { this->late_frames_sensor_ = sensor; };
+            void set_scan_saved_sensor(sensor::Sensor *sensor) { this->scan_saved_sensor_ = sensor; };
+            void set_led_duty_sensor(sensor::Sensor *sensor) { this->led_duty_sensor_ = sensor; };
+#endif
+            void add_parallel_data_pin(uint8_t pin) { this->parallel_data_pins_.push_back((gpio_num_t)pin); };
 
+            /// Draw character `data` in the 8 columns of chip `chip`.
             void send_char(uint8_t chip, uint8_t data);
             void send64pixels(uint8_t chip, const uint8_t pixels[8]);
 
+            /// Move the content one column to the left. With scroll on, the scroll goes on from that column.
             void scroll_left();
+
+            /// Stream `text` through the display instead of showing the drawn content. Only the
+            /// columns about to scroll in are rendered, so the text can be of any length.
+            /// Setting the text already shown does not restart it.
+            void marquee(const std::string &text);
+            /// Stream the text returned by `source`, which is asked again on every repeat.
+            void marquee(marquee_source_t source);
+            /// Go back to showing the drawn content.
+            void stop_marquee();
+
+            /// Play `animation` from its first frame instead of showing the drawn content. The last
+            /// frame stays on when all its loops have been played.
+            void play_animation(Animation *animation);
+            /// Go back to showing the drawn content.
+            void stop_animation();
+            bool is_animation_playing() const { return this->animation_ != nullptr; }
+
+            /// Add a message shown for at least `dwell` ms, rendered once into the playlist arena.
+            PlaylistEntry *add_playlist_entry(const std::string &text, uint32_t dwell);
+            /// Add a message whose text is fetched every update(), it is only rendered again when it changed.
+            PlaylistEntry *add_playlist_entry(playlist_source_t source, uint32_t dwell);
+            /// Show the playlist messages in turn instead of running the writer, from the first message.
+            void playlist_start();
+            void playlist_stop();
+            void playlist_next();
             void scroll(bool on_off, ScrollMode mode, uint16_t speed, uint16_t delay, uint16_t dwell);
             void scroll(bool on_off, ScrollMode mode);
             void scroll(bool on_off);
+            /// Set the global brightness, 0 (dark) to MAX_BRIGHTNESS.
             void intensity(uint8_t intensity);
 
-            /// Evaluate the printf-format and print the result at the given position.
+            /// Evaluate the printf-format and print the result at the given column.
             uint8_t printdigitf(uint8_t pos, const char *format, ...) __attribute__((format(printf, 3, 4)));
             /// Evaluate the printf-format and print the result at position 0.
             uint8_t printdigitf(const char *format, ...) __attribute__((format(printf, 2, 3)));
 
-            /// Print `str` at the given position.
+            /// Print `str` starting at the given column, text past the display width scrolls.
             uint8_t printdigit(uint8_t pos, const char *str);
             /// Print `str` at position 0.
             uint8_t printdigit(const char *str);
 
 #ifdef USE_TIME
-            /// Evaluate the strftime-format and print the result at the given position.
+            /// Evaluate the strftime-format and print the result at the given column.
             uint8_t strftimedigit(uint8_t pos, const char *format, time::ESPTime time) __attribute__((format(strftime, 3, 0)));
 
             /// Evaluate the strftime-format and print the result at position 0.
@@ -89,45 +212,191 @@ namespace esphome
 #endif
 
         protected:
-            void send_byte_(uint8_t a_register, uint8_t data);
-            //void send_to_all_(uint8_t a_register, uint8_t data);
-
-            uint8_t num_chips_;
-            uint8_t num_chip_lines_;
-
-            bool scroll_;
-            bool reverse_;
-            bool update_{false};
-
-            uint16_t scroll_speed_;
-            uint16_t scroll_delay_;
-            uint16_t scroll_dwell_;
-            uint16_t old_buffer_size_ = 0;
-            ScrollMode scroll_mode_;
-            bool invert_ = false;
+            static void scan_timer_callback_(void *arg);
+            bool setup_transport_();
+            void scan_row_();
+            void scan_bcm_();
+            bool scan_powered_();
+            void scan_frame_start_();
+            void apply_scan_rate_(uint16_t rate);
+            /// The transport may be shared with other panels, it gets this panel's orientation before every row.
+            void orient_transport_()
+            {
+                this->transport_->set_invert(this->invert_.load(std::memory_order_relaxed));
+                this->transport_->set_mirror(this->reverse_);
+            }
+            uint32_t lit_rows_(const FrameBuffer &frame) const;
+            float led_duty_() const;
+            uint32_t subframe_time_(uint8_t bit) const;
+            uint32_t subframe_lit_time_(uint8_t bit) const;
+            uint32_t advance_subframe_();
+            bool scroll_step_(uint32_t now, uint16_t content, bool enable, ScrollMode mode, uint16_t speed);
+            void marquee_step_(uint32_t now);
+            void marquee_start_();
+            void animation_step_(uint32_t now);
+            void animation_window_(uint8_t line, uint8_t plane, uint32_t *dst);
+            void playlist_step_(uint32_t now);
+            void playlist_show_(size_t index, uint32_t now, uint16_t leaving_offset);
+            void playlist_window_(uint8_t line, uint8_t plane, uint32_t *dst);
+            uint16_t transition_span_(const PlaylistEntry *entry);
+            void draw_writer_();
+#ifdef USE_LED_DISPLAY_INGEST
+            void ingest_step_(uint32_t now);
+            bool ingest_frame_(int size);
+            void ingest_catch_up_();
+#endif
+            void publish_stats_();
+            void copy_window_(const uint32_t *src, uint16_t start, uint16_t content, uint16_t offset,
+                              uint32_t *dst, uint16_t dst_column, uint16_t count);
+            uint16_t draw_glyph_(uint16_t x, char c);
+            uint16_t draw_text_(uint16_t x, const char *s, uint8_t &count);
+            uint16_t redraw_text_(uint16_t x, const char *s, const TextCache::Cell &previous, uint8_t &count);
+            void drop_retained_text_();
+            /// Called before drawing anything but text, such a frame is not kept for the next update.
+            void draw_other_()
+            {
+                this->text_cache_.set_mixed();
+                if (this->text_retained_)
+                    this->drop_retained_text_();
+            }
+            uint8_t color_level_(Color color) const;
+            bool clip_span_(int &x, int &y, int &width, int &height);
+
+            // defaults match the YAML ones, for panels that are not set up from display.py
+            uint8_t num_chips_{10};
+            uint8_t num_chip_lines_{7};
+            uint16_t max_width_{1024};
+
+            bool scroll_{true};
+            bool reverse_{false};
+            bool flipped_{false};
+            bool frame_dirty_{true};
+
+            uint16_t scroll_speed_{250};
+            uint16_t scroll_delay_{1000};
+            uint16_t scroll_dwell_{1000};
+            uint32_t content_hash_{0};
+            ScrollMode scroll_mode_{CONTINUOUS};
+            std::atomic<bool> invert_{false}; // read by the scan, nothing else is published with it
             uint8_t bckgrnd_ = 0x0;
-            std::vector<std::vector<bool>> led_displaybuffer_;
-            uint32_t last_scroll_ = 0;
-            uint16_t stepsleft_;
+            TextFont font_type_{FONT_5X7};
+            const Font *font_{&get_font(FONT_5X7)};
+            FrameBuffer buffer_; // drawing canvas, max_width_ columns of which width() are in use
+            TextCache text_cache_;
+            bool text_retained_{false}; // this update draws over the previous frame's text
+            bool text_changed_{false};
+            std::vector<char> text_format_; // printdigitf()/strftimedigit() output, allocated in setup()
+            uint32_t last_scroll_ = 0; // start of the current scroll pass
+            uint16_t scroll_offset_{0}; // first canvas column shown at the left edge
+            Marquee marquee_;
+            bool marquee_active_{false};
+            Animation *animation_{nullptr}; // still playing, the canvas holds its current frame
+            FrameBuffer animation_canvas_;
+            bool animation_active_{false};
+            uint32_t animation_since_{0}; // start of the current frame
+            uint16_t animation_duration_{0};
+            Playlist playlist_;
+            uint16_t playlist_arena_width_{1024};
+            bool playlist_active_{false};
+            bool playlist_pass_done_{false}; // the current message scrolled all the way through
+            size_t playlist_index_{0};
+            size_t playlist_prev_{0};
+            uint16_t playlist_prev_offset_{0};
+            uint32_t playlist_since_{0};
+            uint16_t transition_step_{0}; // columns (rows when scrolling vertically) of the current message shown so far
+            bool blink_dark_{false};
             size_t get_buffer_length_();
             optional<ledDisplay_writer_t> writer_local_{};
 
+            // background row scan
+            OutputTransportType transport_type_{TRANSPORT_GPIO};
+            OutputTransport *transport_{nullptr};
+            uint32_t data_rate_{8000000};
+            std::vector<gpio_num_t> parallel_data_pins_;
+            std::atomic<uint32_t> row_shift_time_us_{0};
+            ScanTimer scan_timer_;
+            TripleBuffer scan_frames_; // shifted rows, handed from display() to the scanner
+            PanelGeometry geometry_;
+            FrameBuffer window_; // visible window before the tile mapping, unused with a single panel
+
+            // raw frames over UDP, received into the spare and swapped in
+#ifdef USE_LED_DISPLAY_INGEST
+            FrameIngest ingest_;
+            FrameBuffer ingest_spare_;
+            uint16_t ingest_port_{0};
+            uint32_t ingest_timeout_{5000};
+            uint32_t ingest_last_{0};
+            // the rectangles of the last publishes, so a rectangle only brings back() up to date where they were
+            struct IngestRect
+            {
+                uint32_t publish;
+                uint16_t x;
+                uint8_t y;
+                uint16_t width;
+                uint8_t height;
+            };
+            static const uint8_t INGEST_RECTS = 4;
+            IngestRect ingest_rects_[INGEST_RECTS]{};
+#endif
+            bool ingest_active_{false}; // stays false without ingest
+            bool scan_task_{false};
+            uint16_t refresh_rate_{100};
+            uint32_t row_period_us_{0};
+            uint32_t row_on_time_us_{0}; // 0 is the full row period
+            uint32_t base_row_period_us_{0}; // at refresh_rate_, the current ones follow scan_rate_
+            uint32_t base_row_on_time_us_{0};
+
+            // power saving, the main loop sets the targets and the scanner applies them at a frame start
+            std::atomic<uint8_t> scan_state_{SCAN_RUNNING};
+            std::atomic<uint16_t> scan_rate_{0};
+            uint16_t applied_rate_{0};
+            uint8_t applied_panels_{0}; // sharing the latch when the rate was applied
+            uint16_t idle_refresh_rate_{0};
+            uint32_t idle_after_{2000};
+            uint32_t last_publish_{0};
+            bool skip_blank_rows_{false}; // only set by a low_power: block
+            uint32_t scan_lit_rows_{0xFFFFFFFFUL}; // rows of the front frame with a lit pixel
+            uint8_t scan_line_{0};
+            uint8_t scan_bit_{0}; // current binary code modulation sub-frame
+            uint32_t subframe_shift_us_{0};
+            bool row_lit_{false};
+            std::atomic<uint8_t> brightness_{MAX_BRIGHTNESS};
+            bool gray_scale_{false};
+
             // gpio
-            static const GPIOPin ROW1 = GPIO_NUM_12;
-            static const GPIOPin ROW2 = GPIO_NUM_14;
-            static const GPIOPin ROW3 = GPIO_NUM_27;
-            static const GPIOPin ROW4 = GPIO_NUM_26;
-            static const GPIOPin ROW5 = GPIO_NUM_25;
-            static const GPIOPin ROW6 = GPIO_NUM_33;
-            static const GPIOPin ROW7 = GPIO_NUM_32;
-
-            static const GPIOPin ShiftClock = GPIO_NUM_5;
-            static const GPIOPin ShiftData = GPIO_NUM_16;
-            static const GPIOPin ShiftClear = GPIO_NUM_17;
-            static const GPIOPin LatchClock = GPIO_NUM_17;
-            static const GPIOPin MasterClr = GPIO_NUM_18;
-
-            std::vector<GPIOPin> rows = {ROW7, ROW6, ROW5, ROW4, ROW3, ROW2, ROW1};
+            static const gpio_num_t ShiftClock = GPIO_NUM_5;
+            static const gpio_num_t ShiftData = GPIO_NUM_16;
+            static const gpio_num_t ShiftClear = GPIO_NUM_17;
+            static const gpio_num_t LatchClock = GPIO_NUM_17;
+            static const gpio_num_t MasterClr = GPIO_NUM_18;
+
+            // instrumentation, counters are only incremented on the scan path
+            std::atomic<uint32_t> frames_{0};
+            std::atomic<uint32_t> shifts_{0};
+            std::atomic<uint32_t> max_jitter_us_{0};
+            uint32_t max_loop_us_{0};
+            TimingHistogram jitter_histogram_; // since boot, unlike the maxima that the sensors reset
+            TimingHistogram loop_histogram_;
+            uint32_t update_us_{0};
+            uint32_t stats_last_ms_{0};
+            uint32_t stats_frames_{0};
+            uint32_t stats_missed_{0};
+            uint32_t stats_dropped_{0};
+            uint32_t stats_late_{0};
+            uint32_t stats_shifts_{0};
+#ifdef USE_SENSOR
+            sensor::Sensor *frame_rate_sensor_{nullptr};
+            sensor::Sensor *row_jitter_sensor_{nullptr};
+            sensor::Sensor *loop_time_sensor_{nullptr};
+            sensor::Sensor *update_time_sensor_{nullptr};
+            sensor::Sensor *missed_deadlines_sensor_{nullptr};
+            sensor::Sensor *dropped_frames_sensor_{nullptr};
+            sensor::Sensor *late_frames_sensor_{nullptr};
+            sensor::Sensor *scan_saved_sensor_{nullptr};
+            sensor::Sensor *led_duty_sensor_{nullptr};
+#endif
+
+            std::vector<gpio_num_t> rows = {GPIO_NUM_32, GPIO_NUM_33, GPIO_NUM_25, GPIO_NUM_26, GPIO_NUM_27, GPIO_NUM_14, GPIO_NUM_12};
 
             //  static const int MAX_COLUMNS = 80;
             //  static const int MAX_ROWS = 7;
@@ -0,0 +1,74 @@
+#include "animation.h"
+#include "esphome/core/hal.h"
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+        uint16_t Animation::restart(FrameBuffer &canvas)
+        {
+            if (canvas.width() != this->width_ || canvas.height() != this->height_ || canvas.planes() != this->planes_)
+                canvas.init(this->height_, this->width_, 0, this->planes_);
+            canvas.fill(false);
+            this->pos_ = this->data_;
+            this->frame_ = 0;
+            this->loop_ = 0;
+            return this->decode_(canvas);
+        }
+
+        uint16_t Animation::next(FrameBuffer &canvas)
+        {
+            if (++this->frame_ < this->frames_)
+                return this->decode_(canvas);
+            if (this->loops_ != 0 && ++this->loop_ >= this->loops_)
+            {
+                this->frame_--;
+                return 0;
+            }
+            const uint16_t loop = this->loop_;
+            const uint16_t duration = this->restart(canvas);
+            this->loop_ = loop;
+            return duration;
+        }
+
+        uint16_t Animation::decode_(FrameBuffer &canvas)
+        {
+            const uint8_t *p = this->pos_;
+            const uint16_t duration = progmem_read_byte(p) | (progmem_read_byte(p + 1) << 8);
+            p += 2;
+
+            // Stream the codes straight into the canvas words, one row of bytes after the other
+            const uint16_t row_bytes = (this->width_ + 7) / 8;
+            const uint16_t rows = this->planes_ * this->height_;
+            uint16_t row = 0;
+            uint16_t column = 0; // byte within the row
+            uint32_t *words = canvas.row(0, 0);
+            while (row < rows)
+            {
+                const uint8_t code = progmem_read_byte(p++);
+                uint8_t count = (code & (code & 0x80 ? 0x3F : 0x7F)) + 1;
+                const bool skip = (code & 0xC0) == 0x80;
+                const bool repeat = (code & 0xC0) == 0xC0;
+                const uint8_t fill = repeat ? progmem_read_byte(p++) : 0;
+                for (; count > 0 && row < rows; count--)
+                {
+                    if (!skip)
+                    {
+                        const uint8_t value = repeat ? fill : progmem_read_byte(p++);
+                        words[column / 4] ^= (uint32_t)value << ((column % 4) * 8);
+                    }
+                    if (++column == row_bytes)
+                    {
+                        column = 0;
+                        if (++row < rows)
+                            words = canvas.row(row % this->height_, row / this->height_);
+                    }
+                }
+            }
+            this->pos_ = p;
+            return duration;
+        }
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
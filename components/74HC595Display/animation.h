@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+
+#include "framebuffer.h"
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+        /// A frame sequence kept in flash, generated by display.py from an image file. Frames are
+        /// decoded one at a time over the previous one, only a single frame is ever in RAM.
+        ///
+        /// Every frame is its duration in ms (16 bit little endian) followed by codes covering all
+        /// bytes of the frame: planes x rows x ceil(width / 8), the columns of a byte LSB first.
+        ///   0x00-0x7F  n + 1 literal bytes follow, XORed into the frame
+        ///   0x80-0xBF  (n & 0x3F) + 1 bytes are unchanged
+        ///   0xC0-0xFF  the next byte is XORed into (n & 0x3F) + 1 bytes
+        /// The first frame is XORed into a blank frame.
+        class Animation
+        {
+        public:
+            Animation(const uint8_t *data, uint16_t width, uint8_t height, uint8_t planes, uint16_t frames)
+                : data_(data), pos_(data), width_(width), height_(height), planes_(planes), frames_(frames) {}
+
+            /// Number of times the sequence is played, 0 repeats it forever.
+            void set_loops(uint16_t loops) { this->loops_ = loops; }
+
+            uint16_t get_width() const { return this->width_; }
+            uint8_t get_height() const { return this->height_; }
+            uint8_t get_planes() const { return this->planes_; }
+            uint16_t get_frames() const { return this->frames_; }
+
+            /// Blank `canvas` and decode the first frame into it. Returns its duration in ms.
+            uint16_t restart(FrameBuffer &canvas);
+            /// Decode the next frame over the one in `canvas`, wrapping around to the first frame
+            /// for another loop. Returns its duration in ms, 0 when all loops have been played.
+            uint16_t next(FrameBuffer &canvas);
+
+        protected:
+            uint16_t decode_(FrameBuffer &canvas);
+
+            const uint8_t *data_;
+            const uint8_t *pos_; // start of the next frame
+            uint16_t width_;
+            uint8_t height_;
+            uint8_t planes_;
+            uint16_t frames_;
+            uint16_t loops_{0};
+            uint16_t frame_{0};
+            uint16_t loop_{0};
+        };
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
@@ -1,7 +1,24 @@
 import esphome.codegen as cg
 import esphome.config_validation as cv
-from esphome.components import display
-from esphome.const import CONF_ID, CONF_LAMBDA, CONF_NUM_CHIPS
+import esphome.final_validate as fv
+from esphome import core, pins
+from esphome.components import display, sensor
+from esphome.const import (
+    CONF_FILE,
+    CONF_ID,
+    CONF_INTENSITY,
+    CONF_LAMBDA,
+    CONF_NUM_CHIPS,
+    CONF_PLATFORM,
+    CONF_PORT,
+    CONF_RAW_DATA_ID,
+    CONF_TEXT,
+    CONF_TIMEOUT,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    STATE_CLASS_MEASUREMENT,
+    UNIT_PERCENT,
+)
+from esphome.core import CORE, HexInt
 
 CODEOWNERS = ["@ruudvd"]
 #DEPENDENCIES = [""]
@@ -13,8 +30,66 @@ CONF_SCROLL_ENABLE = "scroll_enable"
 CONF_SCROLL_MODE = "scroll_mode"
 CONF_REVERSE_ENABLE = "reverse_enable"
 CONF_NUM_CHIP_LINES = "num_chip_lines"
+CONF_MAX_WIDTH = "max_width"
+CONF_TEXT_FONT = "text_font"
+CONF_GRAY_SCALE = "gray_scale"
+CONF_FRAME_RATE = "frame_rate"
+CONF_ROW_JITTER = "row_jitter"
+CONF_LOOP_TIME = "loop_time"
+CONF_UPDATE_TIME = "update_time"
+CONF_MISSED_DEADLINES = "missed_deadlines"
+CONF_DROPPED_FRAMES = "dropped_frames"
+CONF_LATE_FRAMES = "late_frames"
+CONF_INGEST = "ingest"
+CONF_LOW_POWER = "low_power"
+CONF_IDLE_REFRESH_RATE = "idle_refresh_rate"
+CONF_IDLE_AFTER = "idle_after"
+CONF_SKIP_BLANK_ROWS = "skip_blank_rows"
+CONF_SCAN_TIME_SAVED = "scan_time_saved"
+CONF_LED_DUTY = "led_duty"
+
+UNIT_FRAMES_PER_SECOND = "fps"
+UNIT_MICROSECOND = "µs"
+CONF_REFRESH_RATE = "refresh_rate"
+CONF_ROW_ON_TIME = "row_on_time"
+CONF_TRANSPORT = "transport"
+CONF_DATA_RATE = "data_rate"
+CONF_PARALLEL_DATA_PINS = "parallel_data_pins"
+CONF_SCAN_TASK = "scan_task"
+CONF_ROW_PINS = "row_pins"
+CONF_FLIP_ROWS = "flip_rows"
+CONF_TILES = "tiles"
+CONF_TILE_COLUMNS = "columns"
+CONF_TILE_ROWS = "rows"
+CONF_CHAIN_ORDER = "chain_order"
+CONF_PLAYLIST = "playlist"
+CONF_ARENA_WIDTH = "arena_width"
+CONF_MESSAGES = "messages"
+CONF_DWELL = "dwell"
+CONF_TRANSITION = "transition"
+CONF_TRANSITION_TIME = "transition_time"
+CONF_BLINK = "blink"
+CONF_ANIMATIONS = "animations"
+CONF_FRAME_DURATION = "frame_duration"
+CONF_LOOPS = "loops"
+
+CONF_DISPLAY = "display"
+PLATFORM = "74HC595Display"
+# panels sharing the shift clock, latch and clear pins, see ScanScheduler
+MAX_PANELS = 8
+
+
+def AUTO_LOAD():
+    # The socket and network components are only needed by panels that receive frames
+    panels = (CORE.raw_config or {}).get(CONF_DISPLAY) or []
+    if any(isinstance(conf, dict) and conf.get(CONF_PLATFORM) == PLATFORM and CONF_INGEST in conf for conf in panels):
+        return ["sensor", "socket", "network"]
+    return ["sensor"]
 
-integration_ns = cg.esphome_ns.namespace("74HC595Display")
+# top row first
+DEFAULT_ROW_PINS = [32, 33, 25, 26, 27, 14, 12]
+
+integration_ns = cg.esphome_ns.namespace("LedDisplay_ns")
 
 ScrollMode = integration_ns.enum("ScrollMode")
 SCROLL_MODES = {
@@ -22,18 +97,221 @@ SCROLL_MODES = {
     "STOP": ScrollMode.STOP,
 }
 
-LedDisplay_ns = cg.esphome_ns.namespace("74HC595Display")
+OutputTransportType = integration_ns.enum("OutputTransportType")
+TRANSPORTS = {
+    "GPIO": OutputTransportType.TRANSPORT_GPIO,
+    "SPI": OutputTransportType.TRANSPORT_SPI,
+    "PARALLEL": OutputTransportType.TRANSPORT_PARALLEL,
+}
+
+TextFont = integration_ns.enum("TextFont")
+TEXT_FONTS = {
+    "5X7": TextFont.FONT_5X7,
+    "5X7_PROPORTIONAL": TextFont.FONT_5X7_PROPORTIONAL,
+}
+
+PlaylistTransition = integration_ns.enum("PlaylistTransition")
+PLAYLIST_TRANSITIONS = {
+    "NONE": PlaylistTransition.TRANSITION_NONE,
+    "WIPE": PlaylistTransition.TRANSITION_WIPE,
+    "SLIDE": PlaylistTransition.TRANSITION_SLIDE,
+    "SCROLL_UP": PlaylistTransition.TRANSITION_SCROLL_UP,
+    "SCROLL_DOWN": PlaylistTransition.TRANSITION_SCROLL_DOWN,
+}
+
+LedDisplay_ns = cg.esphome_ns.namespace("LedDisplay_ns")
+PlaylistEntry = LedDisplay_ns.class_("PlaylistEntry")
+Animation = LedDisplay_ns.class_("Animation")
 LedDisplayComponent = LedDisplay_ns.class_(
     "LedDisplayComponent", cg.PollingComponent, display.DisplayBuffer
 )
 LedDisplayComponentRef = LedDisplayComponent.operator("ref")
 
-CONFIG_SCHEMA = (
+
+def validate_scan_timing(config):
+    row_period = 1000000 // (config[CONF_REFRESH_RATE] * config[CONF_NUM_CHIP_LINES])
+    if (
+        CONF_ROW_ON_TIME in config
+        and config[CONF_ROW_ON_TIME].total_microseconds > row_period
+    ):
+        raise cv.Invalid(
+            f"{CONF_ROW_ON_TIME} can be at most {row_period}us at {config[CONF_REFRESH_RATE]}Hz"
+        )
+    return config
+
+
+def display_width(config):
+    return config[CONF_NUM_CHIPS] * 8 * config[CONF_TILES][CONF_TILE_COLUMNS]
+
+
+def tile_count(config):
+    return config[CONF_TILES][CONF_TILE_COLUMNS] * config[CONF_TILES][CONF_TILE_ROWS]
+
+
+def validate_max_width(config):
+    if config[CONF_MAX_WIDTH] < display_width(config):
+        raise cv.Invalid(
+            f"{CONF_MAX_WIDTH} must be at least the display width of {display_width(config)} columns"
+        )
+    return config
+
+
+def validate_geometry(config):
+    if config[CONF_NUM_CHIP_LINES] > len(config[CONF_ROW_PINS]):
+        raise cv.Invalid(
+            f"{CONF_NUM_CHIP_LINES} needs as many {CONF_ROW_PINS}, only {len(config[CONF_ROW_PINS])} given"
+        )
+    if CONF_CHAIN_ORDER in config and sorted(config[CONF_CHAIN_ORDER]) != list(
+        range(tile_count(config))
+    ):
+        raise cv.Invalid(
+            f"{CONF_CHAIN_ORDER} must list every tile index from 0 to {tile_count(config) - 1} once"
+        )
+    return config
+
+
+def validate_parallel_chains(config):
+    if config[CONF_TRANSPORT] != "PARALLEL":
+        if CONF_PARALLEL_DATA_PINS in config:
+            raise cv.Invalid(f"{CONF_PARALLEL_DATA_PINS} requires transport: PARALLEL")
+        return config
+    if CONF_PARALLEL_DATA_PINS not in config:
+        raise cv.Invalid(f"transport: PARALLEL requires {CONF_PARALLEL_DATA_PINS}")
+    chains = len(config[CONF_PARALLEL_DATA_PINS])
+    if (config[CONF_NUM_CHIPS] * tile_count(config)) % chains != 0:
+        raise cv.Invalid(
+            f"The {CONF_NUM_CHIPS} of all tiles must split evenly over the {chains} parallel chains"
+        )
+    return config
+
+
+def parallel_data_pin(value):
+    value = pins.internal_gpio_output_pin_number(value)
+    if value >= 32:
+        raise cv.Invalid("Parallel data pins must be GPIO0-GPIO31")
+    return value
+
+
+def validate_low_power(config):
+    if CONF_LOW_POWER not in config:
+        return config
+    if config[CONF_LOW_POWER][CONF_IDLE_REFRESH_RATE] > config[CONF_REFRESH_RATE]:
+        raise cv.Invalid(
+            f"{CONF_IDLE_REFRESH_RATE} can be at most the {CONF_REFRESH_RATE} of {config[CONF_REFRESH_RATE]}Hz"
+        )
+    return config
+
+
+def final_validate_shared_scan(config):
+    panels = [
+        conf
+        for conf in fv.full_config.get().get(CONF_DISPLAY, [])
+        if conf.get(CONF_PLATFORM) == PLATFORM
+    ]
+    if len(panels) > MAX_PANELS:
+        raise cv.Invalid(f"At most {MAX_PANELS} {PLATFORM} panels can share the scan")
+    for other in panels:
+        if other[CONF_ID] == config[CONF_ID]:
+            continue
+        for key in (CONF_TRANSPORT, CONF_SCAN_TASK):
+            if other[key] != config[key]:
+                raise cv.Invalid(
+                    f"All {PLATFORM} panels share the shift pins and scan, {key} must be the same for all"
+                )
+        if config[CONF_TRANSPORT] == "SPI" and other[CONF_DATA_RATE] != config[CONF_DATA_RATE]:
+            raise cv.Invalid(f"Panels on the shared SPI bus need the same {CONF_DATA_RATE}")
+        shared = set(config[CONF_ROW_PINS]) & set(other[CONF_ROW_PINS])
+        if shared:
+            raise cv.Invalid(
+                f"{CONF_ROW_PINS} {sorted(shared)} are also used by panel {other[CONF_ID]}"
+            )
+    return config
+
+
+def validate_playlist(config):
+    if CONF_PLAYLIST not in config:
+        return config
+    if config[CONF_PLAYLIST][CONF_ARENA_WIDTH] < display_width(config):
+        raise cv.Invalid(
+            f"{CONF_ARENA_WIDTH} must be at least the display width of {display_width(config)} columns"
+        )
+    return config
+
+
+# Scroll settings left out fall back to the ones of the display
+PLAYLIST_MESSAGE_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(PlaylistEntry),
+        cv.Required(CONF_TEXT): cv.templatable(cv.string),
+        cv.Optional(CONF_DWELL, default="5s"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_SCROLL_ENABLE): cv.boolean,
+        cv.Optional(CONF_SCROLL_MODE): cv.enum(SCROLL_MODES, upper=True),
+        cv.Optional(CONF_SCROLL_SPEED): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_TRANSITION, default="NONE"): cv.enum(
+            PLAYLIST_TRANSITIONS, upper=True
+        ),
+        cv.Optional(
+            CONF_TRANSITION_TIME, default="500ms"
+        ): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_BLINK): cv.positive_time_period_milliseconds,
+    }
+)
+
+# Frame durations come from the file (GIF), frame_duration overrides them
+ANIMATION_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_ID): cv.declare_id(Animation),
+        cv.Required(CONF_FILE): cv.file_,
+        cv.Optional(CONF_FRAME_DURATION): cv.All(
+            cv.positive_time_period_milliseconds,
+            cv.Range(min=cv.TimePeriod(milliseconds=1), max=cv.TimePeriod(milliseconds=65535)),
+        ),
+        cv.Optional(CONF_LOOPS, default=0): cv.int_range(min=0, max=65535),
+        cv.GenerateID(CONF_RAW_DATA_ID): cv.declare_id(cg.uint8),
+    }
+)
+
+# Raw frames pushed by a host, see IngestHeader in ingest.h for the datagram layout
+INGEST_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_PORT, default=7777): cv.port,
+        cv.Optional(CONF_TIMEOUT, default="5s"): cv.positive_time_period_milliseconds,
+    }
+)
+
+# Scan slower once nothing changed for idle_after; 60Hz is about the lowest rate without visible flicker
+LOW_POWER_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_IDLE_REFRESH_RATE, default=60): cv.int_range(min=25, max=1000),
+        cv.Optional(CONF_IDLE_AFTER, default="2s"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_SKIP_BLANK_ROWS, default=True): cv.boolean,
+    }
+)
+
+TILES_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_TILE_COLUMNS, default=1): cv.int_range(min=1, max=8),
+        cv.Optional(CONF_TILE_ROWS, default=1): cv.int_range(min=1, max=8),
+    }
+)
+
+PLAYLIST_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_ARENA_WIDTH, default=1024): cv.int_range(min=8, max=8192),
+        cv.Required(CONF_MESSAGES): cv.All(
+            cv.ensure_list(PLAYLIST_MESSAGE_SCHEMA), cv.Length(min=1)
+        ),
+    }
+)
+
+
+CONFIG_SCHEMA = cv.All(
     display.BASIC_DISPLAY_SCHEMA.extend(
         {
             cv.GenerateID(): cv.declare_id(LedDisplayComponent),
             cv.Optional(CONF_NUM_CHIPS, default=10): cv.int_range(min=1, max=20),
             cv.Optional(CONF_NUM_CHIP_LINES, default=7): cv.int_range(min=1, max=20),
+            cv.Optional(CONF_MAX_WIDTH, default=1024): cv.int_range(min=8, max=8192),
             cv.Optional(CONF_SCROLL_MODE, default="CONTINUOUS"): cv.enum(
                 SCROLL_MODES, upper=True
             ),
@@ -47,12 +325,159 @@ CONFIG_SCHEMA = (
             cv.Optional(
                 CONF_SCROLL_DWELL, default="1000ms"
             ): cv.positive_time_period_milliseconds,
+            # shift the last column first, for chains running from right to left
             cv.Optional(CONF_REVERSE_ENABLE, default=False): cv.boolean,
+            cv.Optional(CONF_FLIP_ROWS, default=False): cv.boolean,
+            cv.Optional(CONF_ROW_PINS, default=DEFAULT_ROW_PINS): cv.All(
+                cv.ensure_list(pins.internal_gpio_output_pin_number),
+                cv.Length(min=1, max=20),
+            ),
+            cv.Optional(CONF_TILES, default={}): TILES_SCHEMA,
+            cv.Optional(CONF_CHAIN_ORDER): cv.ensure_list(cv.uint8_t),
+            cv.Optional(CONF_INTENSITY, default=15): cv.int_range(min=0, max=15),
+            cv.Optional(CONF_GRAY_SCALE, default=False): cv.boolean,
+            cv.Optional(CONF_TEXT_FONT, default="5X7"): cv.enum(TEXT_FONTS, upper=True),
+            cv.Optional(CONF_REFRESH_RATE, default=100): cv.int_range(min=25, max=1000),
+            cv.Optional(CONF_ROW_ON_TIME): cv.positive_time_period_microseconds,
+            cv.Optional(CONF_TRANSPORT, default="GPIO"): cv.enum(TRANSPORTS, upper=True),
+            cv.Optional(CONF_DATA_RATE, default="8MHz"): cv.All(
+                cv.frequency, cv.int_range(min=100000, max=20000000)
+            ),
+            cv.Optional(CONF_SCAN_TASK, default=False): cv.boolean,
+            cv.Optional(CONF_FRAME_RATE): sensor.sensor_schema(
+                unit_of_measurement=UNIT_FRAMES_PER_SECOND,
+                accuracy_decimals=1,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_ROW_JITTER): sensor.sensor_schema(
+                unit_of_measurement=UNIT_MICROSECOND,
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_LOOP_TIME): sensor.sensor_schema(
+                unit_of_measurement=UNIT_MICROSECOND,
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_UPDATE_TIME): sensor.sensor_schema(
+                unit_of_measurement=UNIT_MICROSECOND,
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_MISSED_DEADLINES): sensor.sensor_schema(
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_DROPPED_FRAMES): sensor.sensor_schema(
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_LATE_FRAMES): sensor.sensor_schema(
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_SCAN_TIME_SAVED): sensor.sensor_schema(
+                unit_of_measurement=UNIT_PERCENT,
+                accuracy_decimals=1,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_LED_DUTY): sensor.sensor_schema(
+                unit_of_measurement=UNIT_PERCENT,
+                accuracy_decimals=1,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_INGEST): INGEST_SCHEMA,
+            cv.Optional(CONF_LOW_POWER): LOW_POWER_SCHEMA,
+            cv.Optional(CONF_PARALLEL_DATA_PINS): cv.All(
+                cv.ensure_list(parallel_data_pin), cv.Length(min=2, max=8)
+            ),
+            cv.Optional(CONF_PLAYLIST): PLAYLIST_SCHEMA,
+            cv.Optional(CONF_ANIMATIONS): cv.ensure_list(ANIMATION_SCHEMA),
         }
     )
-    .extend(cv.polling_component_schema("500ms"))
+    .extend(cv.polling_component_schema("500ms")),
+    validate_scan_timing,
+    validate_geometry,
+    validate_max_width,
+    validate_parallel_chains,
+    validate_playlist,
+    validate_low_power,
 )
 
+# Every panel is scanned by the one ScanScheduler
+FINAL_VALIDATE_SCHEMA = final_validate_shared_scan
+
+
+def encode_animation_delta(previous, current):
+    """Run length code the XOR of two frames, in the format described in animation.h"""
+    delta = [a ^ b for a, b in zip(previous, current)]
+    data = []
+    i = 0
+    while i < len(delta):
+        run = 1
+        while i + run < len(delta) and run < 64 and delta[i + run] == delta[i]:
+            run += 1
+        if delta[i] == 0:
+            data.append(0x80 | (run - 1))
+            i += run
+        elif run >= 3:
+            data += [0xC0 | (run - 1), delta[i]]
+            i += run
+        else:
+            # literal bytes up to the next unchanged byte or run of three
+            start = i
+            while i < len(delta) and i - start < 128 and delta[i] != 0:
+                if i + 2 < len(delta) and delta[i] == delta[i + 1] == delta[i + 2]:
+                    break
+                i += 1
+            data.append(i - start - 1)
+            data += delta[start:i]
+    return data
+
+
+def load_animation(conf, planes):
+    from PIL import Image
+
+    path = CORE.relative_config_path(conf[CONF_FILE])
+    try:
+        image = Image.open(path)
+    except Exception as err:
+        raise core.EsphomeError(f"Could not load image file {path}: {err}")
+
+    width, height = image.size
+    frames = getattr(image, "n_frames", 1)
+    row_bytes = (width + 7) // 8
+    previous = [0] * (planes * height * row_bytes)
+    data = []
+    for index in range(frames):
+        image.seek(index)
+        if CONF_FRAME_DURATION in conf:
+            duration = conf[CONF_FRAME_DURATION].total_milliseconds
+        else:
+            duration = min(max(image.info.get("duration", 100), 1), 65535)
+        pixels = image.convert("L").load()
+        # 1 plane is on/off, gray scale keeps the top BRIGHTNESS_BITS of every pixel
+        frame = [0] * len(previous)
+        for plane in range(planes):
+            for y in range(height):
+                for x in range(width):
+                    level = pixels[x, y] >> 4 if planes > 1 else int(pixels[x, y] >= 128)
+                    if (level >> plane) & 1:
+                        frame[(plane * height + y) * row_bytes + x // 8] |= 1 << (x % 8)
+        data += [duration & 0xFF, duration >> 8]
+        data += encode_animation_delta(previous, frame)
+        previous = frame
+    return data, width, height, frames
+
 
 async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
@@ -61,12 +486,89 @@ async def to_code(config):
 
     cg.add(var.set_num_chips(config[CONF_NUM_CHIPS]))
     cg.add(var.set_num_chip_lines(config[CONF_NUM_CHIP_LINES]))
+    cg.add(var.set_max_width(config[CONF_MAX_WIDTH]))
     cg.add(var.set_scroll_speed(config[CONF_SCROLL_SPEED]))
     cg.add(var.set_scroll_dwell(config[CONF_SCROLL_DWELL]))
     cg.add(var.set_scroll_delay(config[CONF_SCROLL_DELAY]))
     cg.add(var.set_scroll(config[CONF_SCROLL_ENABLE]))
     cg.add(var.set_scroll_mode(config[CONF_SCROLL_MODE]))
     cg.add(var.set_reverse(config[CONF_REVERSE_ENABLE]))
+    cg.add(var.set_flip_rows(config[CONF_FLIP_ROWS]))
+    cg.add(var.set_row_pins(config[CONF_ROW_PINS]))
+    cg.add(
+        var.set_tiles(
+            config[CONF_TILES][CONF_TILE_COLUMNS], config[CONF_TILES][CONF_TILE_ROWS]
+        )
+    )
+    if CONF_CHAIN_ORDER in config:
+        cg.add(var.set_chain_order(config[CONF_CHAIN_ORDER]))
+    cg.add(var.set_font(config[CONF_TEXT_FONT]))
+    cg.add(var.set_intensity(config[CONF_INTENSITY]))
+    cg.add(var.set_gray_scale(config[CONF_GRAY_SCALE]))
+    cg.add(var.set_refresh_rate(config[CONF_REFRESH_RATE]))
+    if CONF_ROW_ON_TIME in config:
+        cg.add(var.set_row_on_time(config[CONF_ROW_ON_TIME].total_microseconds))
+    cg.add(var.set_transport(config[CONF_TRANSPORT]))
+    cg.add(var.set_data_rate(config[CONF_DATA_RATE]))
+    cg.add(var.set_scan_task(config[CONF_SCAN_TASK]))
+    for pin in config.get(CONF_PARALLEL_DATA_PINS, []):
+        cg.add(var.add_parallel_data_pin(pin))
+
+    for key, setter in (
+        (CONF_FRAME_RATE, var.set_frame_rate_sensor),
+        (CONF_ROW_JITTER, var.set_row_jitter_sensor),
+        (CONF_LOOP_TIME, var.set_loop_time_sensor),
+        (CONF_UPDATE_TIME, var.set_update_time_sensor),
+        (CONF_MISSED_DEADLINES, var.set_missed_deadlines_sensor),
+        (CONF_DROPPED_FRAMES, var.set_dropped_frames_sensor),
+        (CONF_LATE_FRAMES, var.set_late_frames_sensor),
+        (CONF_SCAN_TIME_SAVED, var.set_scan_saved_sensor),
+        (CONF_LED_DUTY, var.set_led_duty_sensor),
+    ):
+        if key in config:
+            sens = await sensor.new_sensor(config[key])
+            cg.add(setter(sens))
+
+    if CONF_LOW_POWER in config:
+        low_power = config[CONF_LOW_POWER]
+        cg.add(var.set_idle_refresh_rate(low_power[CONF_IDLE_REFRESH_RATE]))
+        cg.add(var.set_idle_after(low_power[CONF_IDLE_AFTER]))
+        cg.add(var.set_skip_blank_rows(low_power[CONF_SKIP_BLANK_ROWS]))
+
+    if CONF_INGEST in config:
+        cg.add_define("USE_LED_DISPLAY_INGEST")
+        cg.add(var.set_ingest_port(config[CONF_INGEST][CONF_PORT]))
+        cg.add(var.set_ingest_timeout(config[CONF_INGEST][CONF_TIMEOUT]))
+
+    if CONF_PLAYLIST in config:
+        playlist = config[CONF_PLAYLIST]
+        cg.add(var.set_playlist_arena_width(playlist[CONF_ARENA_WIDTH]))
+        for message in playlist[CONF_MESSAGES]:
+            text = message[CONF_TEXT]
+            if cg.is_template(text):
+                text = await cg.process_lambda(text, [], return_type=cg.std_string)
+            entry = cg.Pvariable(
+                message[CONF_ID], var.add_playlist_entry(text, message[CONF_DWELL])
+            )
+            cg.add(
+                entry.set_scroll(message.get(CONF_SCROLL_ENABLE, config[CONF_SCROLL_ENABLE]))
+            )
+            cg.add(
+                entry.set_scroll_mode(message.get(CONF_SCROLL_MODE, config[CONF_SCROLL_MODE]))
+            )
+            if CONF_SCROLL_SPEED in message:
+                cg.add(entry.set_scroll_speed(message[CONF_SCROLL_SPEED]))
+            cg.add(entry.set_transition(message[CONF_TRANSITION]))
+            cg.add(entry.set_transition_time(message[CONF_TRANSITION_TIME]))
+            if CONF_BLINK in message:
+                cg.add(entry.set_blink(message[CONF_BLINK]))
+
+    planes = 4 if config[CONF_GRAY_SCALE] else 1
+    for conf in config.get(CONF_ANIMATIONS, []):
+        data, width, height, frames = load_animation(conf, planes)
+        raw = cg.progmem_array(conf[CONF_RAW_DATA_ID], [HexInt(x) for x in data])
+        animation = cg.new_Pvariable(conf[CONF_ID], raw, width, height, planes, frames)
+        cg.add(animation.set_loops(conf[CONF_LOOPS]))
 
     if CONF_LAMBDA in config:
         lambda_ = await cg.process_lambda(
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+        enum TextFont
+        {
+            FONT_5X7 = 0,
+            FONT_5X7_PROPORTIONAL,
+        };
+
+        static const uint8_t GLYPH_HEIGHT = 7;
+        static const uint8_t GLYPH_MAX_WIDTH = 5;
+        static const char GLYPH_FIRST = ' ';
+        static const char GLYPH_LAST = '~';
+        static const uint8_t GLYPH_COUNT = GLYPH_LAST - GLYPH_FIRST + 1;
+
+        /// One character in panel order: rows[y] bit x is the pixel at column x, the same bit order
+        /// as a FrameBuffer row, so drawing a glyph is one shifted OR per row.
+        struct Glyph
+        {
+            uint8_t width;
+            uint8_t rows[GLYPH_HEIGHT];
+        };
+
+        struct Font
+        {
+            Glyph glyphs[GLYPH_COUNT];
+            uint8_t spacing; // blank columns after every glyph
+
+            /// Glyph for `c`, characters outside the table render as '?'.
+            const Glyph &get(char c) const
+            {
+                if (c < GLYPH_FIRST || c > GLYPH_LAST)
+                    c = '?';
+                return this->glyphs[c - GLYPH_FIRST];
+            }
+        };
+
+        const Font &get_font(TextFont font);
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
@@ -0,0 +1,150 @@
+#include "framebuffer.h"
+
+#include <algorithm>
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+        void FrameBuffer::init(uint8_t height, uint16_t width, uint16_t capacity, uint8_t planes)
+        {
+            this->height_ = height;
+            this->planes_ = planes;
+            this->capacity_ = std::max(width, capacity);
+            this->width_ = width;
+            this->stride_ = words_for(this->capacity_);
+            this->words_.assign(this->planes_ * this->height_ * this->stride_, 0);
+        }
+
+        void FrameBuffer::resize(uint16_t width, bool on)
+        {
+            uint16_t old_width = this->width_;
+            this->width_ = std::min(width, this->capacity_);
+            width = this->width_;
+            if (width > old_width && on)
+                this->fill_columns(old_width, width - old_width, true);
+            else if (width < old_width)
+            {
+                this->clear_padding_();
+            }
+        }
+
+        void FrameBuffer::fill(bool on)
+        {
+            std::fill(this->words_.begin(), this->words_.end(), on ? 0xFFFFFFFFUL : 0);
+            if (on)
+                this->clear_padding_();
+        }
+
+        uint32_t FrameBuffer::hash() const
+        {
+            // FNV-1a over the used words of every row
+            uint32_t hash = 2166136261UL;
+            const uint16_t words = words_for(this->width_);
+            for (uint16_t r = 0; r < this->planes_ * this->height_; r++)
+            {
+                const uint32_t *row = &this->words_[r * this->stride_];
+                for (uint16_t i = 0; i < words; i++)
+                {
+                    hash ^= row[i];
+                    hash *= 16777619UL;
+                }
+            }
+            return hash ^ this->width_;
+        }
+
+        void FrameBuffer::clear_padding_()
+        {
+            // Everything from width_ up to the end of the row must read as off
+            this->fill_columns(this->width_, this->stride_ * WORD_BITS - this->width_, false);
+        }
+
+        void FrameBuffer::fill_rect(uint16_t x, uint8_t y, uint16_t width, uint8_t height, uint8_t level)
+        {
+            for (uint8_t plane = 0; plane < this->planes_; plane++)
+            {
+                const bool on = (level >> plane) & 1;
+                for (uint8_t row = y; row < y + height; row++)
+                    set_bits(this->row(row, plane), x, width, on);
+            }
+        }
+
+        void FrameBuffer::fill_columns(uint16_t x, uint16_t count, bool on)
+        {
+            for (uint16_t r = 0; r < this->planes_ * this->height_; r++)
+                set_bits(&this->words_[r * this->stride_], x, count, on);
+        }
+
+        void FrameBuffer::write_bits(uint8_t y, uint16_t x, const uint32_t *bits, uint16_t count)
+        {
+            for (uint8_t plane = 0; plane < this->planes_; plane++)
+                copy_bits(bits, 0, this->row(y, plane), x, count);
+        }
+
+        void FrameBuffer::copy_bits(const uint32_t *src, uint32_t src_bit, uint32_t *dst, uint32_t dst_bit, uint32_t count)
+        {
+            while (count > 0)
+            {
+                const uint32_t *s = src + src_bit / WORD_BITS;
+                uint32_t s_off = src_bit % WORD_BITS;
+                uint32_t d_off = dst_bit % WORD_BITS;
+                uint32_t n = std::min<uint32_t>(count, WORD_BITS - d_off);
+
+                uint32_t bits = s[0] >> s_off;
+                if (s_off + n > WORD_BITS)
+                    bits |= s[1] << (WORD_BITS - s_off);
+                uint32_t mask = (n == WORD_BITS ? 0xFFFFFFFFUL : ((1UL << n) - 1)) << d_off;
+                uint32_t &d = dst[dst_bit / WORD_BITS];
+                d = (d & ~mask) | ((bits << d_off) & mask);
+
+                src_bit += n;
+                dst_bit += n;
+                count -= n;
+            }
+        }
+
+        void FrameBuffer::set_bits(uint32_t *dst, uint32_t dst_bit, uint32_t count, bool on)
+        {
+            while (count > 0)
+            {
+                uint32_t d_off = dst_bit % WORD_BITS;
+                uint32_t n = std::min<uint32_t>(count, WORD_BITS - d_off);
+                uint32_t mask = (n == WORD_BITS ? 0xFFFFFFFFUL : ((1UL << n) - 1)) << d_off;
+                if (on)
+                    dst[dst_bit / WORD_BITS] |= mask;
+                else
+                    dst[dst_bit / WORD_BITS] &= ~mask;
+                dst_bit += n;
+                count -= n;
+            }
+        }
+
+        static inline uint32_t reverse_word(uint32_t v)
+        {
+            v = ((v >> 1) & 0x55555555UL) | ((v & 0x55555555UL) << 1);
+            v = ((v >> 2) & 0x33333333UL) | ((v & 0x33333333UL) << 2);
+            v = ((v >> 4) & 0x0F0F0F0FUL) | ((v & 0x0F0F0F0FUL) << 4);
+            v = ((v >> 8) & 0x00FF00FFUL) | ((v & 0x00FF00FFUL) << 8);
+            return (v >> 16) | (v << 16);
+        }
+
+        void FrameBuffer::reverse_bits(const uint32_t *src, uint32_t *dst, uint16_t count)
+        {
+            // Reverse whole words, then drop the padding that ended up in front
+            const uint16_t words = words_for(count);
+            const uint16_t pad = words * WORD_BITS - count;
+            for (uint16_t i = 0; i < words; i++)
+                dst[i] = reverse_word(src[words - 1 - i]);
+            if (pad == 0)
+                return;
+            for (uint16_t i = 0; i < words; i++)
+            {
+                dst[i] >>= pad;
+                if (i + 1 < words)
+                    dst[i] |= dst[i + 1] << (WORD_BITS - pad);
+            }
+        }
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
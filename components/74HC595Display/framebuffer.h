@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+        /// Packed one bit per pixel framebuffer, optionally with several bit planes per pixel.
+        ///
+        /// The memory for `capacity()` columns is allocated once by init(); `width()` is the part in
+        /// use and can change freely within the capacity without touching the heap.
+        ///
+        /// Every row is `stride()` contiguous 32-bit words. Column x lives in word x / 32 at bit
+        /// x % 32, which is the order the 74HC595 chain is shifted (column 0 first, LSB first),
+        /// so a row can be handed to the output stage as is. Bits past `width()` are kept 0.
+        ///
+        /// With more than one plane, bit b of a pixel's brightness level is stored in plane b.
+        /// set() and the multi-row helpers write a pixel on (all planes) or off.
+        class FrameBuffer
+        {
+        public:
+            static const uint8_t WORD_BITS = 32;
+
+            static uint16_t words_for(uint16_t columns) { return (columns + WORD_BITS - 1) / WORD_BITS; }
+
+            /// Allocate `height` rows with room for `capacity` columns, `width` of them in use, all off.
+            void init(uint8_t height, uint16_t width, uint16_t capacity = 0, uint8_t planes = 1);
+            /// Change the number of columns in use, keeping the content. New columns are set to `on`.
+            /// The width is clamped to the capacity.
+            void resize(uint16_t width, bool on = false);
+            void fill(bool on);
+            /// Hash of the pixels in use, to detect unchanged content cheaply.
+            uint32_t hash() const;
+
+            bool get(uint16_t x, uint8_t y, uint8_t plane = 0) const
+            {
+                return (this->row(y, plane)[x / WORD_BITS] >> (x % WORD_BITS)) & 1;
+            }
+            void set(uint16_t x, uint8_t y, bool on)
+            {
+                this->set_level(x, y, on ? 0xFF : 0);
+            }
+            /// Store brightness `level`, only the lowest `planes()` bits are kept.
+            void set_level(uint16_t x, uint8_t y, uint8_t level)
+            {
+                uint32_t mask = 1UL << (x % WORD_BITS);
+                for (uint8_t plane = 0; plane < this->planes_; plane++)
+                {
+                    if ((level >> plane) & 1)
+                        this->row(y, plane)[x / WORD_BITS] |= mask;
+                    else
+                        this->row(y, plane)[x / WORD_BITS] &= ~mask;
+                }
+            }
+
+            uint32_t *row(uint8_t y, uint8_t plane = 0) { return &this->words_[(plane * this->height_ + y) * this->stride_]; }
+            const uint32_t *row(uint8_t y, uint8_t plane = 0) const { return &this->words_[(plane * this->height_ + y) * this->stride_]; }
+
+            /// Set a `width` x `height` block of pixels to brightness `level`, word by word.
+            void fill_rect(uint16_t x, uint8_t y, uint16_t width, uint8_t height, uint8_t level);
+            /// Set or clear `count` columns from `x` on every row and plane.
+            void fill_columns(uint16_t x, uint16_t count, bool on);
+            /// Copy `count` packed bits to row `y` from column `x`, into every plane.
+            void write_bits(uint8_t y, uint16_t x, const uint32_t *bits, uint16_t count);
+
+            uint16_t width() const { return this->width_; }
+            uint16_t capacity() const { return this->capacity_; }
+            uint8_t height() const { return this->height_; }
+            uint8_t planes() const { return this->planes_; }
+            uint16_t stride() const { return this->stride_; }
+
+            /// Copy `count` bits between packed rows, both offsets in bits. Ranges must not overlap.
+            static void copy_bits(const uint32_t *src, uint32_t src_bit, uint32_t *dst, uint32_t dst_bit, uint32_t count);
+            /// Set or clear `count` bits starting at bit `dst_bit`.
+            static void set_bits(uint32_t *dst, uint32_t dst_bit, uint32_t count, bool on);
+            /// Copy the first `count` bits of `src` to `dst` in reverse order, bit 0 becomes bit count - 1.
+            /// Bits past `count` in the last word of `dst` are cleared. The rows must not overlap.
+            static void reverse_bits(const uint32_t *src, uint32_t *dst, uint16_t count);
+
+        protected:
+            void clear_padding_();
+
+            std::vector<uint32_t> words_;
+            uint16_t width_{0};
+            uint16_t capacity_{0};
+            uint16_t stride_{0};
+            uint8_t height_{0};
+            uint8_t planes_{1};
+        };
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
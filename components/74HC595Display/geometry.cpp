@@ -0,0 +1,52 @@
+#include "geometry.h"
+
+#include <algorithm>
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+        bool PanelGeometry::init(uint16_t panel_width, uint8_t panel_height)
+        {
+            this->panel_width_ = panel_width;
+            this->panel_height_ = panel_height;
+
+            if (this->chain_order_.empty())
+            {
+                for (uint8_t tile = 0; tile < this->tiles(); tile++)
+                    this->chain_order_.push_back(tile);
+                return true;
+            }
+            std::vector<uint8_t> sorted = this->chain_order_;
+            std::sort(sorted.begin(), sorted.end());
+            for (uint8_t tile = 0; tile < sorted.size(); tile++)
+            {
+                if (sorted[tile] != tile)
+                    return false;
+            }
+            return sorted.size() == this->tiles();
+        }
+
+        void PanelGeometry::map(const FrameBuffer &window, FrameBuffer &chain) const
+        {
+            // One copy of a panel width per tile and row, the cost does not depend on the content
+            for (uint8_t plane = 0; plane < chain.planes(); plane++)
+            {
+                for (uint8_t y = 0; y < this->panel_height_; y++)
+                {
+                    uint32_t *dst = chain.row(y, plane);
+                    for (uint8_t position = 0; position < this->chain_order_.size(); position++)
+                    {
+                        const uint8_t tile = this->chain_order_[position];
+                        const uint8_t tile_x = tile % this->tiles_x_;
+                        const uint8_t tile_y = tile / this->tiles_x_;
+                        const uint32_t *src = window.row(tile_y * this->panel_height_ + y, plane);
+                        FrameBuffer::copy_bits(src, tile_x * this->panel_width_, dst, position * this->panel_width_, this->panel_width_);
+                    }
+                }
+            }
+        }
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
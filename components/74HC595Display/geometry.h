@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "framebuffer.h"
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+        /// How the drawn display maps onto the scanned rows and the shift chain.
+        ///
+        /// The display is `tiles_x` x `tiles_y` identical panels. All panels share the row drivers
+        /// and sit in one shift chain in `chain_order` (tile indexes counted row by row from the
+        /// top left), so every scanned row is the same panel row of all tiles, one after the other.
+        class PanelGeometry
+        {
+        public:
+            void set_tiles(uint8_t tiles_x, uint8_t tiles_y)
+            {
+                this->tiles_x_ = tiles_x;
+                this->tiles_y_ = tiles_y;
+            }
+            void set_chain_order(const std::vector<uint8_t> &order) { this->chain_order_ = order; }
+
+            /// Set the size of one panel. Returns false if the chain order does not list every tile once.
+            bool init(uint16_t panel_width, uint8_t panel_height);
+
+            uint8_t tiles_x() const { return this->tiles_x_; }
+            uint8_t tiles_y() const { return this->tiles_y_; }
+            uint8_t tiles() const { return this->tiles_x_ * this->tiles_y_; }
+            uint16_t chain_bits() const { return this->panel_width_ * this->tiles(); }
+            uint8_t scan_rows() const { return this->panel_height_; }
+
+            /// True when a drawn row is the shifted row as is, so no mapping is needed.
+            bool is_direct() const { return this->tiles() == 1; }
+
+            /// Rearrange the drawn `window` into one chain row per scanned row of `chain`.
+            void map(const FrameBuffer &window, FrameBuffer &chain) const;
+
+        protected:
+            uint8_t tiles_x_{1};
+            uint8_t tiles_y_{1};
+            std::vector<uint8_t> chain_order_;
+            uint16_t panel_width_{0};
+            uint8_t panel_height_{0};
+        };
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
@@ -0,0 +1,42 @@
+#include "histogram.h"
+
+#include <cstdio>
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+        uint32_t TimingHistogram::get_total() const
+        {
+            uint32_t total = 0;
+            for (uint8_t bucket = 0; bucket < BUCKETS; bucket++)
+                total += this->get_count(bucket);
+            return total;
+        }
+
+        void TimingHistogram::format(char *buffer, size_t size) const
+        {
+            size_t used = 0;
+            buffer[0] = '\0';
+            for (uint8_t bucket = 0; bucket < BUCKETS && used < size; bucket++)
+            {
+                const uint32_t count = this->get_count(bucket);
+                if (count == 0)
+                    continue;
+                const char *separator = used == 0 ? "" : ", ";
+                int written;
+                if (bucket == BUCKETS - 1)
+                    written = snprintf(buffer + used, size - used, "%s>=%luus %u", separator, 1UL << (bucket - 1), (unsigned)count);
+                else
+                    written = snprintf(buffer + used, size - used, "%s<%luus %u", separator, 1UL << bucket, (unsigned)count);
+                if (written < 0)
+                    break;
+                used += written;
+            }
+            if (used == 0)
+                snprintf(buffer, size, "-");
+        }
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+        /// Counts durations in power of two buckets, bucket 0 is below 1 us and bucket b below 2^b us.
+        /// The last bucket takes everything longer. add() is one relaxed increment, so the scan path
+        /// can use it; the counts only ever grow.
+        class TimingHistogram
+        {
+        public:
+            static const uint8_t BUCKETS = 16;
+
+            void add(uint32_t us) { this->counts_[bucket_(us)].fetch_add(1, std::memory_order_relaxed); }
+            uint32_t get_count(uint8_t bucket) const { return this->counts_[bucket].load(std::memory_order_relaxed); }
+            uint32_t get_total() const;
+
+            /// Writes "<64us 120, <128us 3" for the buckets that counted anything, "-" if none did.
+            void format(char *buffer, size_t size) const;
+
+        protected:
+            static uint8_t bucket_(uint32_t us)
+            {
+                const uint8_t bits = us == 0 ? 0 : 32 - __builtin_clz(us);
+                return bits < BUCKETS ? bits : BUCKETS - 1;
+            }
+
+            std::atomic<uint32_t> counts_[BUCKETS]{};
+        };
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
@@ -0,0 +1,78 @@
+#include "ingest.h"
+
+#ifdef USE_LED_DISPLAY_INGEST
+
+#include "esphome/core/log.h"
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+        static const char *const TAG = "74HC595Display.ingest";
+
+        bool FrameIngest::begin(uint16_t port)
+        {
+            this->socket_ = socket::socket_ip(SOCK_DGRAM, IPPROTO_UDP);
+            if (this->socket_ == nullptr)
+            {
+                ESP_LOGE(TAG, "Could not create the ingest socket");
+                return false;
+            }
+            struct sockaddr_storage addr;
+            socklen_t len = socket::set_sockaddr_any((struct sockaddr *)&addr, sizeof(addr), port);
+            if (this->socket_->bind((struct sockaddr *)&addr, len) != 0 || this->socket_->setblocking(false) != 0)
+            {
+                ESP_LOGE(TAG, "Could not listen on UDP port %u", port);
+                this->socket_ = nullptr;
+                return false;
+            }
+            return true;
+        }
+
+        int FrameIngest::receive(FrameBuffer &payload)
+        {
+            // Scatter the datagram: the header into header_, the pixels into the frame buffer
+            // itself. A datagram is cut off at the size of the buffers, the byte past them makes one
+            // that is too large come out a byte longer than any frame, which the size check rejects.
+            uint8_t overflow;
+            struct iovec iov[3];
+            iov[0].iov_base = &this->header_;
+            iov[0].iov_len = sizeof(this->header_);
+            iov[1].iov_base = payload.row(0, 0);
+            iov[1].iov_len = payload.planes() * payload.height() * payload.stride() * sizeof(uint32_t);
+            iov[2].iov_base = &overflow;
+            iov[2].iov_len = sizeof(overflow);
+            ssize_t received = this->socket_->readv(iov, 3);
+            if (received < 0)
+                return -1;
+            if (received <= (ssize_t)sizeof(this->header_) || this->header_.magic[0] != 'L' || this->header_.magic[1] != 'D')
+            {
+                this->dropped_++;
+                return 0;
+            }
+            return received - sizeof(this->header_);
+        }
+
+        bool FrameIngest::accept()
+        {
+            const uint32_t sequence = this->header_.sequence;
+            if (this->has_sequence_)
+            {
+                const int32_t ahead = sequence - this->sequence_;
+                if (ahead <= 0)
+                {
+                    this->late_++;
+                    return false;
+                }
+                this->dropped_ += ahead - 1;
+            }
+            this->sequence_ = sequence;
+            this->has_sequence_ = true;
+            return true;
+        }
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
+
+#endif // USE_LED_DISPLAY_INGEST
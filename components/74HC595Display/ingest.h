@@ -0,0 +1,75 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+
+// Only built with an ingest: block in the YAML, which is what loads the socket component
+#ifdef USE_LED_DISPLAY_INGEST
+
+#include <cstdint>
+#include <memory>
+
+#include "esphome/components/socket/socket.h"
+#include "framebuffer.h"
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+        static const uint8_t INGEST_LEVELS = 0x01; // payload has a plane per brightness bit
+
+        /// Header in front of every ingest datagram, all fields little endian.
+        ///
+        /// The payload follows directly: for every plane (1, or BRIGHTNESS_BITS with
+        /// INGEST_LEVELS) `height` rows of `width` columns, each row padded to whole 32-bit
+        /// words with column x at bit x % 32, the FrameBuffer layout. A `width` of 0 is the
+        /// whole display, a rectangle reaching past the right or bottom edge is cut off there.
+        struct IngestHeader
+        {
+            uint8_t magic[2]; // 'L', 'D'
+            uint8_t flags;
+            uint8_t reserved;
+            uint32_t sequence; // incremented by one per frame
+            uint16_t x;
+            uint16_t y;
+            uint16_t width;
+            uint16_t height;
+        } __attribute__((packed));
+
+        /// Receives raw frames over UDP. The payload of a datagram is read straight into the words
+        /// of a FrameBuffer, the caller decides what to do with it based on header().
+        class FrameIngest
+        {
+        public:
+            bool begin(uint16_t port);
+            bool is_ready() const { return this->socket_ != nullptr; }
+
+            /// Read one queued datagram, its payload into `payload` from row 0 of plane 0 on.
+            /// Returns the payload size in bytes, or -1 when nothing is queued.
+            int receive(FrameBuffer &payload);
+            const IngestHeader &header() const { return this->header_; }
+
+            /// Check the sequence number of the received frame. Returns false for a frame that
+            /// is not newer than the last accepted one; gaps count as dropped frames.
+            bool accept();
+            /// Count a frame that was received but not shown.
+            void drop() { this->dropped_++; }
+            /// Accept any sequence number next, for when the sender went away and may restart.
+            void reset_sequence() { this->has_sequence_ = false; }
+
+            uint32_t get_dropped() const { return this->dropped_; }
+            uint32_t get_late() const { return this->late_; }
+
+        protected:
+            std::unique_ptr<socket::Socket> socket_;
+            IngestHeader header_{};
+            uint32_t sequence_{0};
+            bool has_sequence_{false};
+            uint32_t dropped_{0};
+            uint32_t late_{0};
+        };
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
+
+#endif // USE_LED_DISPLAY_INGEST
@@ -0,0 +1,134 @@
+#include "marquee.h"
+
+#include <algorithm>
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+        void Marquee::init(uint8_t height, uint16_t visible, uint8_t planes, const Font *font)
+        {
+            // Room for the window plus the glyph being rendered at its right edge
+            this->visible_ = visible;
+            this->font_ = font;
+            this->ring_.init(height, visible + GLYPH_MAX_WIDTH + font->spacing, 0, planes);
+            this->restart();
+        }
+
+        bool Marquee::set_text(const std::string &text)
+        {
+            if (!this->source_ && text == this->text_)
+                return false;
+            this->source_ = nullptr;
+            this->text_ = text;
+            this->restart();
+            return true;
+        }
+
+        void Marquee::set_source(marquee_source_t &&source)
+        {
+            this->source_ = std::move(source);
+            this->restart();
+        }
+
+        void Marquee::restart()
+        {
+            if (this->font_ == nullptr || this->visible_ == 0)
+                return; // not initialised yet, init() starts the stream
+            if (this->source_)
+                this->text_ = this->source_();
+
+            // One pass over the text decides if it fits, the glyphs themselves are rendered lazily
+            uint32_t width = 0;
+            for (char c : this->text_)
+                width += this->font_->get(c).width + this->font_->spacing;
+            this->scrolls_ = width > this->visible_;
+
+            this->ring_.fill(false);
+            this->position_ = 0;
+            this->rendered_ = 0;
+            this->next_char_ = 0;
+            this->text_done_ = false;
+            this->stepped_ = false;
+            this->render_ahead_(false);
+        }
+
+        void Marquee::step(bool wrap)
+        {
+            if (!wrap && this->at_end())
+                return;
+            this->position_++;
+            this->stepped_ = true;
+            // Only the positions modulo the ring width matter, keep them from overflowing
+            if (this->position_ >= this->ring_.width())
+            {
+                this->position_ -= this->ring_.width();
+                this->rendered_ -= this->ring_.width();
+            }
+            this->render_ahead_(wrap);
+        }
+
+        void Marquee::render_ahead_(bool wrap)
+        {
+            const uint16_t ring_width = this->ring_.width();
+            while (this->rendered_ < this->position_ + this->visible_)
+            {
+                if (this->next_char_ < this->text_.size())
+                {
+                    this->render_glyph_(this->text_[this->next_char_++]);
+                    continue;
+                }
+                this->text_done_ = true;
+                if (wrap && this->scrolls_)
+                {
+                    // separate the repeat with a space and start over with fresh text
+                    this->render_glyph_(' ');
+                    if (this->source_)
+                        this->text_ = this->source_();
+                    this->next_char_ = 0;
+                    this->text_done_ = false;
+                    continue;
+                }
+                // nothing left: the columns up to the right edge are blank
+                for (; this->rendered_ < this->position_ + this->visible_; this->rendered_++)
+                    this->ring_.fill_columns(this->rendered_ % ring_width, 1, false);
+                if (!this->scrolls_)
+                    this->text_done_ = true;
+                return;
+            }
+        }
+
+        void Marquee::render_glyph_(char c)
+        {
+            const Glyph &glyph = this->font_->get(c);
+            const uint16_t ring_width = this->ring_.width();
+            const uint16_t advance = glyph.width + this->font_->spacing;
+            const uint16_t start = this->rendered_ % ring_width;
+            const uint16_t first = std::min<uint16_t>(advance, ring_width - start);
+            const uint8_t height = std::min<uint8_t>(this->ring_.height(), GLYPH_HEIGHT);
+            for (uint8_t y = 0; y < height; y++)
+            {
+                uint32_t bits = glyph.rows[y];
+                this->ring_.write_bits(y, start, &bits, first);
+                if (first < advance)
+                {
+                    bits >>= first;
+                    this->ring_.write_bits(y, 0, &bits, advance - first);
+                }
+            }
+            this->rendered_ += advance;
+        }
+
+        void Marquee::copy_window(uint8_t y, uint8_t plane, uint32_t *dst) const
+        {
+            const uint16_t ring_width = this->ring_.width();
+            const uint16_t start = this->position_ % ring_width;
+            const uint16_t first = std::min<uint16_t>(this->visible_, ring_width - start);
+            FrameBuffer::copy_bits(this->ring_.row(y, plane), start, dst, 0, first);
+            if (first < this->visible_)
+                FrameBuffer::copy_bits(this->ring_.row(y, plane), 0, dst, first, this->visible_ - first);
+        }
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "font.h"
+#include "framebuffer.h"
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+        using marquee_source_t = std::function<std::string()>;
+
+        /// Streams text through a ring of `visible` + one glyph columns, rendering glyphs only
+        /// when they are about to enter at the right edge. Memory does not depend on text length.
+        class Marquee
+        {
+        public:
+            void init(uint8_t height, uint16_t visible, uint8_t planes, const Font *font);
+            void set_font(const Font *font)
+            {
+                this->font_ = font;
+                this->restart();
+            }
+
+            /// Use a fixed text. Returns false if it is the text already shown.
+            bool set_text(const std::string &text);
+            /// Ask `source` for the text every time the stream (re)starts.
+            void set_source(marquee_source_t &&source);
+
+            /// Start over at the first column of the text, refetching it from the source.
+            void restart();
+            /// Move the window one column to the left. With `wrap` the text starts over after
+            /// a space when it runs out, otherwise the window stops at the last column.
+            void step(bool wrap);
+
+            /// True when the text is wider than the window and has to be scrolled at all.
+            bool scrolls() const { return this->scrolls_; }
+            /// True until the first step after a (re)start. The ring positions wrap, so this is its own flag.
+            bool at_start() const { return !this->stepped_; }
+            /// True when the last column of the text is at the right edge.
+            bool at_end() const { return this->text_done_ && this->rendered_ <= this->position_ + this->visible_; }
+
+            /// Copy the visible window of row `y` in `plane` to `dst`.
+            void copy_window(uint8_t y, uint8_t plane, uint32_t *dst) const;
+
+        protected:
+            void render_ahead_(bool wrap);
+            void render_glyph_(char c);
+
+            FrameBuffer ring_;
+            const Font *font_{nullptr};
+            std::string text_;
+            marquee_source_t source_;
+            uint16_t visible_{0};
+            uint32_t position_{0}; // stream column at the left edge
+            uint32_t rendered_{0}; // stream columns rendered so far
+            size_t next_char_{0};
+            bool text_done_{false};
+            bool scrolls_{false};
+            bool stepped_{false};
+        };
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
@@ -0,0 +1,233 @@
+#include "output_transport.h"
+#include "framebuffer.h"
+
+#include <cstring>
+
+#ifdef USE_ESP32
+#include <esp_heap_caps.h>
+#include <soc/gpio_reg.h>
+#endif
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+        const uint32_t *OutputTransport::oriented_(const uint32_t *words, uint16_t bits)
+        {
+            if (!this->mirror_)
+                return words;
+            this->mirrored_.resize(FrameBuffer::words_for(bits));
+            FrameBuffer::reverse_bits(words, this->mirrored_.data(), bits);
+            return this->mirrored_.data();
+        }
+
+#ifdef USE_ESP32
+        bool GpioTransport::setup()
+        {
+            panel_pin_setup(this->data_pin_);
+            panel_pin_setup(this->clock_pin_);
+            panel_pin_setup(this->latch_pin_);
+            return true;
+        }
+
+        void GpioTransport::shift_row(const uint32_t *words, uint16_t bits)
+        {
+            // A 74HC595 at 4.5 V or more needs 25 ns of data setup and a 20 ns clock pulse, a
+            // gpio_set_level() call takes longer than that, so the edges need no delays
+            for (uint16_t i = 0; i < bits; i++)
+            {
+                const uint16_t column = this->mirror_ ? bits - 1 - i : i;
+                const bool on = (words[column / FrameBuffer::WORD_BITS] >> (column % FrameBuffer::WORD_BITS)) & 1;
+                panel_pin_write(this->data_pin_, on != this->invert_);
+                panel_pin_write(this->clock_pin_, true);
+                panel_pin_write(this->clock_pin_, false);
+            }
+        }
+
+        void GpioTransport::latch()
+        {
+            panel_pin_write(this->latch_pin_, true);
+            delayMicroseconds(1);
+            panel_pin_write(this->latch_pin_, false);
+        }
+
+        SpiTransport::~SpiTransport()
+        {
+            if (this->device_ != nullptr)
+                spi_bus_remove_device(this->device_);
+            if (this->bus_initialized_)
+                spi_bus_free(SPI2_HOST);
+            heap_caps_free(this->dma_buffer_);
+        }
+
+        bool SpiTransport::setup()
+        {
+            panel_pin_setup(this->latch_pin_);
+
+            uint16_t words = FrameBuffer::words_for(this->max_bits_);
+            this->dma_buffer_ = static_cast<uint32_t *>(heap_caps_malloc(words * sizeof(uint32_t), MALLOC_CAP_DMA));
+            if (this->dma_buffer_ == nullptr)
+                return false;
+
+            spi_bus_config_t bus = {};
+            bus.mosi_io_num = this->data_pin_;
+            bus.miso_io_num = -1;
+            bus.sclk_io_num = this->clock_pin_;
+            bus.quadwp_io_num = -1;
+            bus.quadhd_io_num = -1;
+            bus.max_transfer_sz = words * sizeof(uint32_t);
+            if (spi_bus_initialize(SPI2_HOST, &bus, SPI_DMA_CH_AUTO) != ESP_OK)
+                return false;
+            this->bus_initialized_ = true;
+
+            spi_device_interface_config_t dev = {};
+            dev.mode = 0; // 74HC595 shifts on the rising edge
+            dev.clock_speed_hz = this->clock_hz_;
+            dev.spics_io_num = -1;
+            dev.flags = SPI_DEVICE_TXBIT_LSBFIRST;
+            dev.queue_size = 1;
+            return spi_bus_add_device(SPI2_HOST, &dev, &this->device_) == ESP_OK;
+        }
+
+        void SpiTransport::shift_row(const uint32_t *words, uint16_t bits)
+        {
+            // DMA needs its own buffer anyway, so mirroring and inverting are folded into the copy
+            uint16_t count = FrameBuffer::words_for(bits);
+            if (this->mirror_)
+            {
+                FrameBuffer::reverse_bits(words, this->dma_buffer_, bits);
+                if (this->invert_)
+                {
+                    for (uint16_t i = 0; i < count; i++)
+                        this->dma_buffer_[i] = ~this->dma_buffer_[i];
+                }
+            }
+            else if (this->invert_)
+            {
+                for (uint16_t i = 0; i < count; i++)
+                    this->dma_buffer_[i] = ~words[i];
+            }
+            else
+            {
+                memcpy(this->dma_buffer_, words, count * sizeof(uint32_t));
+            }
+
+            spi_transaction_t transaction = {};
+            transaction.length = bits;
+            transaction.tx_buffer = this->dma_buffer_;
+            // Polling keeps the latency of a short row transfer below that of an interrupt round trip
+            spi_device_polling_transmit(this->device_, &transaction);
+        }
+
+        void SpiTransport::latch()
+        {
+            panel_pin_write(this->latch_pin_, true);
+            panel_pin_write(this->latch_pin_, false);
+        }
+
+        bool ParallelGpioTransport::setup()
+        {
+            if (this->data_pins_.size() < 2 || this->data_pins_.size() > MAX_CHAINS)
+                return false;
+            for (uint8_t c = 0; c < this->data_pins_.size(); c++)
+            {
+                const gpio_num_t pin = this->data_pins_[c];
+                if (pin >= 32)
+                    return false;
+                panel_pin_setup(pin);
+                this->pin_masks_[c] = 1UL << pin;
+                this->data_mask_ |= this->pin_masks_[c];
+            }
+            if (this->clock_pin_ >= 32)
+                return false;
+            panel_pin_setup(this->clock_pin_);
+            panel_pin_setup(this->latch_pin_);
+            this->clock_mask_ = 1UL << this->clock_pin_;
+            return true;
+        }
+
+        void ParallelGpioTransport::shift_row(const uint32_t *words, uint16_t bits)
+        {
+            words = this->oriented_(words, bits);
+            switch (this->data_pins_.size())
+            {
+            case 2:
+                return this->shift_chains_<2>(words, bits);
+            case 3:
+                return this->shift_chains_<3>(words, bits);
+            case 4:
+                return this->shift_chains_<4>(words, bits);
+            case 5:
+                return this->shift_chains_<5>(words, bits);
+            case 6:
+                return this->shift_chains_<6>(words, bits);
+            case 7:
+                return this->shift_chains_<7>(words, bits);
+            default:
+                return this->shift_chains_<8>(words, bits);
+            }
+        }
+
+        template <uint8_t CHAINS>
+        void ParallelGpioTransport::shift_chains_(const uint32_t *words, uint16_t bits)
+        {
+            const uint16_t chain_bits = bits / CHAINS;
+            for (uint16_t j = 0; j < chain_bits; j++)
+            {
+                uint32_t set_mask = 0;
+                uint16_t column = j;
+                for (uint8_t c = 0; c < CHAINS; c++, column += chain_bits)
+                {
+                    if (((words[column / FrameBuffer::WORD_BITS] >> (column % FrameBuffer::WORD_BITS)) & 1) != this->invert_)
+                        set_mask |= this->pin_masks_[c];
+                }
+                // clock low together with the zero data bits, then the one bits, then the rising edge
+                REG_WRITE(GPIO_OUT_W1TC_REG, (this->data_mask_ & ~set_mask) | this->clock_mask_);
+                REG_WRITE(GPIO_OUT_W1TS_REG, set_mask);
+                REG_WRITE(GPIO_OUT_W1TS_REG, this->clock_mask_);
+            }
+            REG_WRITE(GPIO_OUT_W1TC_REG, this->clock_mask_);
+        }
+
+        void ParallelGpioTransport::latch()
+        {
+            panel_pin_write(this->latch_pin_, true);
+            panel_pin_write(this->latch_pin_, false);
+        }
+#endif
+
+        void RecordingTransport::shift_row(const uint32_t *words, uint16_t bits)
+        {
+            words = this->oriented_(words, bits);
+            this->shift_register_.assign(words, words + FrameBuffer::words_for(bits));
+            if (this->invert_)
+            {
+                for (auto &word : this->shift_register_)
+                    word = ~word;
+                FrameBuffer::set_bits(this->shift_register_.data(), bits, this->shift_register_.size() * FrameBuffer::WORD_BITS - bits, false);
+            }
+            this->shifted_bits_ += bits;
+        }
+
+        void RecordingTransport::latch()
+        {
+            // The slots keep their capacity, once every one was used a row is copied without allocating
+            this->outputs_ = this->shift_register_;
+            if (!this->latched_.empty())
+            {
+                this->latched_[this->next_slot_] = this->shift_register_;
+                this->next_slot_ = (this->next_slot_ + 1) % this->latched_.size();
+            }
+            this->latches_++;
+        }
+
+        void RecordingTransport::clear()
+        {
+            this->next_slot_ = 0;
+            this->latches_ = 0;
+            this->shifted_bits_ = 0;
+        }
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "esphome/core/defines.h"
+#include "esphome/core/hal.h"
+#include "panel_pins.h"
+
+#ifdef USE_ESP32
+#include <driver/spi_master.h>
+#endif
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+        enum OutputTransportType
+        {
+            TRANSPORT_GPIO = 0,
+            TRANSPORT_SPI,
+            TRANSPORT_RECORDING,
+            TRANSPORT_PARALLEL,
+        };
+
+        /// Moves one packed row (see FrameBuffer) into the 74HC595 chain.
+        class OutputTransport
+        {
+        public:
+            virtual ~OutputTransport() = default;
+
+            virtual bool setup() = 0;
+            virtual const char *get_name() const = 0;
+
+            /// Shift `bits` columns into the chain, column 0 first, without touching the outputs.
+            virtual void shift_row(const uint32_t *words, uint16_t bits) = 0;
+            /// Pulse the storage register clock so the shifted row appears on the outputs.
+            virtual void latch() = 0;
+            /// Longest row shift_row() takes, 0 if there is no limit.
+            virtual uint16_t get_max_bits() const { return 0; }
+
+            void set_invert(bool invert) { this->invert_ = invert; }
+            /// Shift the last column first, for chains that run from right to left.
+            void set_mirror(bool mirror) { this->mirror_ = mirror; }
+
+        protected:
+            /// `words`, or a copy with the columns in shift order if mirrored.
+            const uint32_t *oriented_(const uint32_t *words, uint16_t bits);
+
+            bool invert_{false};
+            bool mirror_{false};
+            std::vector<uint32_t> mirrored_;
+        };
+
+#ifdef USE_ESP32
+        /// Bit-bangs the data and shift clock lines, one gpio_set_level per edge.
+        class GpioTransport : public OutputTransport
+        {
+        public:
+            GpioTransport(gpio_num_t data_pin, gpio_num_t clock_pin, gpio_num_t latch_pin)
+                : data_pin_(data_pin), clock_pin_(clock_pin), latch_pin_(latch_pin) {}
+
+            bool setup() override;
+            const char *get_name() const override { return "GPIO"; }
+            void shift_row(const uint32_t *words, uint16_t bits) override;
+            void latch() override;
+
+        protected:
+            gpio_num_t data_pin_;
+            gpio_num_t clock_pin_;
+            gpio_num_t latch_pin_;
+        };
+
+        /// Clocks a whole row out with a single DMA transaction on a hardware SPI bus.
+        /// The bus runs LSB first so the little-endian row words go out column 0 first.
+        class SpiTransport : public OutputTransport
+        {
+        public:
+            SpiTransport(gpio_num_t data_pin, gpio_num_t clock_pin, gpio_num_t latch_pin, uint32_t clock_hz, uint16_t max_bits)
+                : data_pin_(data_pin), clock_pin_(clock_pin), latch_pin_(latch_pin), clock_hz_(clock_hz), max_bits_(max_bits) {}
+            ~SpiTransport() override;
+
+            bool setup() override;
+            const char *get_name() const override { return "SPI"; }
+            void shift_row(const uint32_t *words, uint16_t bits) override;
+            void latch() override;
+            uint16_t get_max_bits() const override { return this->max_bits_; }
+
+        protected:
+            gpio_num_t data_pin_;
+            gpio_num_t clock_pin_;
+            gpio_num_t latch_pin_;
+            uint32_t clock_hz_;
+            uint16_t max_bits_;
+            bool bus_initialized_{false};
+            spi_device_handle_t device_{nullptr};
+            uint32_t *dma_buffer_{nullptr};
+        };
+
+        /// Drives several chains that share the shift clock and latch, one data pin per chain.
+        /// Chain c gets columns [c * bits / chains, (c + 1) * bits / chains). All data lines of a
+        /// clock edge are updated with one set and one clear register write, so the row time does
+        /// not grow with the number of chains. Pins must be GPIO0-31 (the first output register).
+        /// The loop over the chains is specialised for every supported chain count.
+        class ParallelGpioTransport : public OutputTransport
+        {
+        public:
+            ParallelGpioTransport(std::vector<gpio_num_t> data_pins, gpio_num_t clock_pin, gpio_num_t latch_pin)
+                : data_pins_(std::move(data_pins)), clock_pin_(clock_pin), latch_pin_(latch_pin) {}
+
+            bool setup() override;
+            const char *get_name() const override { return "Parallel GPIO"; }
+            void shift_row(const uint32_t *words, uint16_t bits) override;
+            void latch() override;
+
+            static const uint8_t MAX_CHAINS = 8;
+
+        protected:
+            template <uint8_t CHAINS>
+            void shift_chains_(const uint32_t *words, uint16_t bits);
+
+            std::vector<gpio_num_t> data_pins_;
+            gpio_num_t clock_pin_;
+            gpio_num_t latch_pin_;
+            uint32_t data_mask_{0};
+            uint32_t clock_mask_{0};
+            uint32_t pin_masks_[MAX_CHAINS]{};
+        };
+#endif
+
+        /// Keeps the shifted and latched rows in memory instead of driving pins, for host builds.
+        /// Only the last `history` latched rows are kept, in slots reused round robin, so it does
+        /// not grow however long the scan runs.
+        class RecordingTransport : public OutputTransport
+        {
+        public:
+            explicit RecordingTransport(uint16_t history = 0) : latched_(history) {}
+
+            bool setup() override { return true; }
+            const char *get_name() const override { return "Recording"; }
+            void shift_row(const uint32_t *words, uint16_t bits) override;
+            void latch() override;
+
+            /// The row on the outputs, the shift register as of the last latch.
+            const std::vector<uint32_t> &get_outputs() const { return this->outputs_; }
+            /// Latches since clear().
+            uint32_t get_latches() const { return this->latches_; }
+            uint16_t get_history() const { return this->latched_.size(); }
+            /// The row latched `age` latches ago, 0 the last one. Only the last get_history() are kept.
+            const std::vector<uint32_t> &get_latched(uint32_t age) const
+            {
+                return this->latched_[(this->next_slot_ + this->latched_.size() - 1 - age) % this->latched_.size()];
+            }
+            uint32_t get_shifted_bits() const { return this->shifted_bits_; }
+            void clear();
+
+        protected:
+            std::vector<uint32_t> shift_register_;
+            std::vector<uint32_t> outputs_;
+            std::vector<std::vector<uint32_t>> latched_;
+            uint16_t next_slot_{0};
+            uint32_t latches_{0};
+            uint32_t shifted_bits_{0};
+        };
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+
+#include "esphome/core/defines.h"
+
+#ifdef USE_ESP32
+#include <driver/gpio.h>
+#endif
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+#ifdef USE_ESP32
+        inline void panel_pin_setup(gpio_num_t pin)
+        {
+            gpio_reset_pin(pin);
+            gpio_set_direction(pin, GPIO_MODE_OUTPUT);
+        }
+
+        inline void panel_pin_write(gpio_num_t pin, bool level) { gpio_set_level(pin, level); }
+#else
+        // Host builds (ESPHome `host` platform) have no pins: the levels are kept in memory so a
+        // simulation can follow the row drivers next to what RecordingTransport latched.
+        typedef int8_t gpio_num_t;
+
+        static const gpio_num_t GPIO_NUM_5 = 5;
+        static const gpio_num_t GPIO_NUM_12 = 12;
+        static const gpio_num_t GPIO_NUM_14 = 14;
+        static const gpio_num_t GPIO_NUM_16 = 16;
+        static const gpio_num_t GPIO_NUM_17 = 17;
+        static const gpio_num_t GPIO_NUM_18 = 18;
+        static const gpio_num_t GPIO_NUM_25 = 25;
+        static const gpio_num_t GPIO_NUM_26 = 26;
+        static const gpio_num_t GPIO_NUM_27 = 27;
+        static const gpio_num_t GPIO_NUM_32 = 32;
+        static const gpio_num_t GPIO_NUM_33 = 33;
+
+        static const uint8_t HOST_PIN_COUNT = 40;
+
+        inline bool *host_pin_levels()
+        {
+            static bool levels[HOST_PIN_COUNT] = {};
+            return levels;
+        }
+
+        inline void panel_pin_setup(gpio_num_t /*pin*/) {}
+
+        inline void panel_pin_write(gpio_num_t pin, bool level)
+        {
+            if (pin >= 0 && pin < HOST_PIN_COUNT)
+                host_pin_levels()[pin] = level;
+        }
+#endif
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
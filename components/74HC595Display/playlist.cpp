@@ -0,0 +1,126 @@
+#include "playlist.h"
+#include "esphome/core/log.h"
+
+#include <algorithm>
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+        static const char *const TAG = "74HC595Display.playlist";
+
+        void Playlist::init(uint8_t height, uint16_t capacity, uint8_t planes, const Font *font)
+        {
+            this->arena_.init(height, capacity, capacity, planes);
+            this->font_ = font;
+            this->layout_();
+        }
+
+        void Playlist::set_font(const Font *font)
+        {
+            if (!this->ready())
+                return;
+            this->font_ = font;
+            this->layout_();
+        }
+
+        PlaylistEntry *Playlist::add(PlaylistEntry *entry)
+        {
+            this->entries_.push_back(entry);
+            if (this->ready())
+                this->layout_();
+            return entry;
+        }
+
+        bool Playlist::refresh()
+        {
+            if (!this->ready())
+                return false;
+
+            bool relayout = false;
+            bool changed = false;
+            for (auto *entry : this->entries_)
+            {
+                if (entry->source_)
+                {
+                    std::string text = entry->source_();
+                    if (text != entry->text_)
+                    {
+                        entry->text_ = std::move(text);
+                        entry->changed_ = true;
+                    }
+                }
+                if (!entry->changed_)
+                    continue;
+                changed = true;
+                if (this->text_width_(entry->text_) > entry->slot_)
+                    relayout = true;
+            }
+
+            if (relayout)
+            {
+                this->layout_();
+            }
+            else if (changed)
+            {
+                for (auto *entry : this->entries_)
+                {
+                    if (entry->changed_)
+                        this->render_(entry);
+                }
+            }
+            return changed;
+        }
+
+        uint16_t Playlist::text_width_(const std::string &text) const
+        {
+            uint32_t width = 0;
+            for (char c : text)
+                width += this->font_->get(c).width + this->font_->spacing;
+            return std::min<uint32_t>(width, UINT16_MAX);
+        }
+
+        void Playlist::layout_()
+        {
+            // Pack all messages from column 0, every slot exactly as wide as its text
+            uint16_t start = 0;
+            for (auto *entry : this->entries_)
+            {
+                const uint16_t room = this->arena_.width() - start;
+                const uint16_t width = this->text_width_(entry->text_);
+                if (width > room)
+                    ESP_LOGW(TAG, "Playlist arena full, cutting off \"%s\"", entry->text_.c_str());
+                entry->start_ = start;
+                entry->slot_ = std::min(width, room);
+                start += entry->slot_;
+                this->render_(entry);
+            }
+        }
+
+        void Playlist::render_(PlaylistEntry *entry)
+        {
+            this->arena_.fill_columns(entry->start_, entry->slot_, false);
+
+            const uint16_t end = entry->start_ + entry->slot_;
+            const uint8_t height = std::min<uint8_t>(this->arena_.height(), GLYPH_HEIGHT);
+            uint16_t x = entry->start_;
+            for (char c : entry->text_)
+            {
+                if (x >= end)
+                    break;
+                const Glyph &glyph = this->font_->get(c);
+                const uint16_t count = std::min<uint16_t>(glyph.width + this->font_->spacing, end - x);
+                for (uint8_t y = 0; y < height; y++)
+                {
+                    uint32_t bits = glyph.rows[y];
+                    this->arena_.write_bits(y, x, &bits, count);
+                }
+                x += count;
+            }
+            entry->width_ = x - entry->start_;
+            entry->changed_ = false;
+        }
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "font.h"
+#include "framebuffer.h"
+#include "scroll_mode.h"
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+        enum PlaylistTransition
+        {
+            TRANSITION_NONE = 0,
+            TRANSITION_WIPE,  // the next message is uncovered from the left
+            TRANSITION_SLIDE, // the next message pushes the current one out to the left
+            TRANSITION_SCROLL_UP,   // the next message comes in from below, pushing the current one up
+            TRANSITION_SCROLL_DOWN, // the next message comes in from above, pushing the current one down
+        };
+
+        using playlist_source_t = std::function<std::string()>;
+
+        /// One message of a Playlist and how it is shown.
+        class PlaylistEntry
+        {
+        public:
+            PlaylistEntry(std::string text, uint32_t dwell) : text_(std::move(text)), dwell_(dwell) {}
+            PlaylistEntry(playlist_source_t &&source, uint32_t dwell) : source_(std::move(source)), dwell_(dwell) {}
+
+            void set_scroll(bool scroll) { this->scroll_ = scroll; }
+            void set_scroll_mode(ScrollMode mode) { this->scroll_mode_ = mode; }
+            /// Time per scrolled column, 0 uses the display's scroll_speed.
+            void set_scroll_speed(uint16_t speed) { this->scroll_speed_ = speed; }
+            void set_transition(PlaylistTransition transition) { this->transition_ = transition; }
+            void set_transition_time(uint16_t time) { this->transition_time_ = time; }
+            /// Blink the message, `interval` ms on and off. 0 does not blink.
+            void set_blink(uint16_t interval) { this->blink_ = interval; }
+
+            const std::string &get_text() const { return this->text_; }
+            uint32_t get_dwell() const { return this->dwell_; }
+            bool get_scroll() const { return this->scroll_; }
+            ScrollMode get_scroll_mode() const { return this->scroll_mode_; }
+            uint16_t get_scroll_speed() const { return this->scroll_speed_; }
+            PlaylistTransition get_transition() const { return this->transition_; }
+            uint16_t get_transition_time() const { return this->transition_time_; }
+            uint16_t get_blink() const { return this->blink_; }
+
+            /// First arena column of the rendered text.
+            uint16_t get_start() const { return this->start_; }
+            /// Rendered width in columns.
+            uint16_t get_width() const { return this->width_; }
+
+        protected:
+            friend class Playlist;
+
+            std::string text_; // text as rendered in the arena
+            playlist_source_t source_;
+            uint32_t dwell_;
+            bool scroll_{true};
+            ScrollMode scroll_mode_{CONTINUOUS};
+            uint16_t scroll_speed_{0};
+            PlaylistTransition transition_{TRANSITION_NONE};
+            uint16_t transition_time_{500};
+            uint16_t blink_{0};
+
+            uint16_t start_{0};
+            uint16_t width_{0};
+            uint16_t slot_{0}; // arena columns reserved, text up to this width renders in place
+            bool changed_{true};
+        };
+
+        /// Messages rasterised once into a fixed size arena, side by side.
+        ///
+        /// refresh() only asks the sources for their text; layout and rendering happen when a
+        /// text actually changed. Text that no longer fits its slot moves all messages, text past
+        /// the arena capacity is cut off.
+        class Playlist
+        {
+        public:
+            void init(uint8_t height, uint16_t capacity, uint8_t planes, const Font *font);
+            bool ready() const { return this->font_ != nullptr; }
+            void set_font(const Font *font);
+
+            PlaylistEntry *add(PlaylistEntry *entry);
+            size_t size() const { return this->entries_.size(); }
+            bool empty() const { return this->entries_.empty(); }
+            PlaylistEntry *get(size_t index) const { return this->entries_[index]; }
+
+            /// Fetch the text of all messages and re-render the changed ones.
+            /// Returns true if anything in the arena changed.
+            bool refresh();
+
+            const FrameBuffer &arena() const { return this->arena_; }
+
+        protected:
+            uint16_t text_width_(const std::string &text) const;
+            void layout_();
+            void render_(PlaylistEntry *entry);
+
+            FrameBuffer arena_;
+            const Font *font_{nullptr};
+            std::vector<PlaylistEntry *> entries_;
+        };
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
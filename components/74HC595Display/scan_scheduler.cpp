@@ -0,0 +1,292 @@
+#include "scan_scheduler.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+#include <algorithm>
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+        static const char *const TAG = "74HC595Display.scan";
+
+        ScanScheduler &get_scan_scheduler()
+        {
+            static ScanScheduler scheduler;
+            return scheduler;
+        }
+
+        bool ScanScheduler::add(ScanTimer *timer, bool task)
+        {
+            if (this->count_ == MAX_PANELS)
+            {
+                ESP_LOGE(TAG, "At most %u panels can be scanned", MAX_PANELS);
+                return false;
+            }
+            if (this->count_ == 0 && !this->start_(task))
+                return false;
+            if (task != this->task_)
+                ESP_LOGW(TAG, "All panels are scanned together, scan_task follows the first panel");
+            this->timers_[this->count_] = timer;
+            // publishes the slot to the scanner
+            this->count_++;
+            return true;
+        }
+
+        void ScanScheduler::remove(ScanTimer *timer)
+        {
+            if (std::find(this->timers_, this->timers_ + this->count_, timer) == this->timers_ + this->count_ ||
+                timer->retired_.load(std::memory_order_relaxed))
+                return;
+            timer->retired_.store(true, std::memory_order_relaxed);
+            timer->stop();
+            // The scanner skips the timer from here on, a scan of it that is running ends before the lock is free
+            this->lock_scans_();
+            this->unlock_scans_();
+            this->release_(timer);
+            if (++this->removed_ == this->count_)
+            {
+                // Nothing left to scan, panels set up after this start from empty slots
+                this->stop_();
+                this->count_ = 0;
+                this->removed_ = 0;
+            }
+        }
+
+        OutputTransport *ScanScheduler::find_transport(OutputTransportType type, const std::vector<gpio_num_t> &data_pins) const
+        {
+            for (auto &shared : this->transports_)
+            {
+                if (shared.type == type && shared.data_pins == data_pins)
+                    return shared.transport.get();
+            }
+            return nullptr;
+        }
+
+        OutputTransport *ScanScheduler::add_transport(OutputTransportType type, const std::vector<gpio_num_t> &data_pins,
+                                                      std::unique_ptr<OutputTransport> transport)
+        {
+            this->transports_.push_back({type, data_pins, std::move(transport)});
+            return this->transports_.back().transport.get();
+        }
+
+        bool ScanScheduler::start_(bool task)
+        {
+            this->task_ = task;
+#ifdef USE_ESP32
+            if (this->scan_lock_ == nullptr)
+                this->scan_lock_ = xSemaphoreCreateMutex();
+            if (this->scan_lock_ == nullptr)
+                return false;
+            esp_timer_create_args_t args = {};
+            args.callback = &ScanScheduler::timer_callback_;
+            args.arg = this;
+            args.dispatch_method = ESP_TIMER_TASK;
+            args.name = "74hc595_scan";
+            if (task)
+            {
+                // The timer only wakes the task, the scans run on the core the main loop does not use
+#if portNUM_PROCESSORS > 1
+                const BaseType_t core = xPortGetCoreID() == 0 ? 1 : 0;
+#else
+                const BaseType_t core = tskNO_AFFINITY;
+#endif
+                if (xTaskCreatePinnedToCore(&ScanScheduler::task_loop_, "74hc595_scan", 3072, this,
+                                            configMAX_PRIORITIES - 5, &this->task_handle_, core) != pdPASS)
+                    return false;
+                args.callback = &ScanScheduler::task_wake_;
+            }
+            return esp_timer_create(&args, &this->handle_) == ESP_OK;
+#else
+            if (task)
+            {
+                this->thread_running_ = true;
+                this->thread_ = std::thread(&ScanScheduler::thread_loop_, this);
+            }
+            return true;
+#endif
+        }
+
+        void ScanScheduler::stop_()
+        {
+#ifdef USE_ESP32
+            esp_timer_stop(this->handle_);
+            esp_timer_delete(this->handle_);
+            this->handle_ = nullptr;
+            if (this->task_handle_ != nullptr)
+            {
+                vTaskDelete(this->task_handle_);
+                this->task_handle_ = nullptr;
+            }
+#else
+            {
+                std::lock_guard<std::mutex> guard(this->wake_lock_);
+                this->thread_running_ = false;
+            }
+            this->wake_cv_.notify_one();
+            if (this->thread_.joinable())
+                this->thread_.join();
+#endif
+        }
+
+        void ScanScheduler::poll()
+        {
+#ifndef USE_ESP32
+            if (!this->task_)
+                this->dispatch_();
+#endif
+        }
+
+        void ScanScheduler::dispatch_()
+        {
+            // Every scan that is due, earliest first. A few rounds at most, so panels that are far
+            // behind do not keep the other timer callbacks waiting.
+            const uint8_t rounds = 2 * this->count_;
+            this->lock_scans_();
+            for (uint8_t round = 0; round < rounds; round++)
+            {
+                ScanTimer *next = this->next_();
+                const uint32_t now = micros();
+                if (next == nullptr || (int32_t)(next->deadline_.load(std::memory_order_relaxed) - now) > 0)
+                    break;
+                if (next->waited_.exchange(false, std::memory_order_relaxed))
+                {
+                    // Its slot starts now, the dark part of it will be shorter
+                    next->slip_ = now - next->deadline_.load(std::memory_order_relaxed);
+                    next->deadline_.store(now, std::memory_order_relaxed);
+                }
+                next->running_.store(false, std::memory_order_relaxed);
+                this->current_ = next;
+                next->callback_(next->arg_);
+                this->current_ = nullptr;
+            }
+            this->unlock_scans_();
+            this->rearm_();
+        }
+
+        ScanTimer *ScanScheduler::next_() const
+        {
+            ScanTimer *holder = this->holder_;
+            ScanTimer *next = nullptr;
+            const uint8_t count = this->count_;
+            for (uint8_t i = 0; i < count; i++)
+            {
+                ScanTimer *timer = this->timers_[i];
+                if (!timer->running_.load(std::memory_order_acquire) || timer->retired_.load(std::memory_order_relaxed) ||
+                    (holder != nullptr && holder != timer))
+                    continue;
+                if (next == nullptr ||
+                    (int32_t)(timer->deadline_.load(std::memory_order_relaxed) - next->deadline_.load(std::memory_order_relaxed)) < 0)
+                    next = timer;
+            }
+            return next;
+        }
+
+        void ScanScheduler::rearm_()
+        {
+#ifdef USE_ESP32
+            // A panel armed from the main loop sets wake_pending_ before it kicks the timer, look
+            // again if that happened while the next deadline was being picked
+            do
+            {
+                this->wake_pending_ = false;
+                ScanTimer *next = this->next_();
+                esp_timer_stop(this->handle_);
+                if (next != nullptr)
+                {
+                    const int32_t delay_us = (int32_t)(next->deadline_.load(std::memory_order_relaxed) - micros());
+                    esp_timer_start_once(this->handle_, delay_us > 0 ? delay_us : 0);
+                }
+            } while (this->wake_pending_);
+#endif
+        }
+
+        void ScanScheduler::wake_()
+        {
+#ifdef USE_ESP32
+            this->wake_pending_ = true;
+            esp_timer_stop(this->handle_);
+            esp_timer_start_once(this->handle_, 0);
+#else
+            if (!this->task_)
+                return;
+            {
+                std::lock_guard<std::mutex> guard(this->wake_lock_);
+                this->wake_pending_ = true;
+            }
+            this->wake_cv_.notify_one();
+#endif
+        }
+
+        void ScanScheduler::release_(ScanTimer *timer)
+        {
+            ScanTimer *holder = timer;
+            if (!this->holder_.compare_exchange_strong(holder, nullptr))
+                return;
+            // Whoever came due while the latch was held gets its full slot from now on
+            const uint32_t now = micros();
+            const uint8_t count = this->count_;
+            for (uint8_t i = 0; i < count; i++)
+            {
+                ScanTimer *other = this->timers_[i];
+                if (other != timer && other->running_.load(std::memory_order_acquire) &&
+                    (int32_t)(now - other->deadline_.load(std::memory_order_relaxed)) >= 0)
+                    other->waited_.store(true, std::memory_order_relaxed);
+            }
+        }
+
+#ifdef USE_ESP32
+        void ScanScheduler::lock_scans_() { xSemaphoreTake(this->scan_lock_, portMAX_DELAY); }
+
+        void ScanScheduler::unlock_scans_() { xSemaphoreGive(this->scan_lock_); }
+
+        void ScanScheduler::timer_callback_(void *arg) { static_cast<ScanScheduler *>(arg)->dispatch_(); }
+
+        void ScanScheduler::task_loop_(void *arg)
+        {
+            for (;;)
+            {
+                ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+                static_cast<ScanScheduler *>(arg)->dispatch_();
+            }
+        }
+
+        void ScanScheduler::task_wake_(void *arg)
+        {
+            xTaskNotifyGive(static_cast<ScanScheduler *>(arg)->task_handle_);
+        }
+#else
+        void ScanScheduler::lock_scans_() { this->scan_lock_.lock(); }
+
+        void ScanScheduler::unlock_scans_() { this->scan_lock_.unlock(); }
+
+        void ScanScheduler::thread_loop_()
+        {
+            // Host stand-in for the scan task: sleeps until the earliest deadline, or until a panel
+            // is armed from outside its own scan
+            auto woken = [this] { return this->wake_pending_ || !this->thread_running_; };
+            std::unique_lock<std::mutex> lock(this->wake_lock_);
+            while (this->thread_running_)
+            {
+                this->wake_pending_ = false;
+                lock.unlock();
+                this->dispatch_();
+                lock.lock();
+                if (woken())
+                    continue;
+                ScanTimer *next = this->next_();
+                if (next == nullptr)
+                {
+                    this->wake_cv_.wait(lock, woken);
+                    continue;
+                }
+                const int32_t delay_us = (int32_t)(next->deadline_.load(std::memory_order_relaxed) - micros());
+                if (delay_us > 0)
+                    this->wake_cv_.wait_for(lock, std::chrono::microseconds(delay_us), woken);
+            }
+        }
+#endif
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
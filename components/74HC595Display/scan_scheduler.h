@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "esphome/core/defines.h"
+#include "output_transport.h"
+#include "scan_timer.h"
+
+#ifdef USE_ESP32
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+        /// Runs the row scans of every panel from one timer, earliest deadline first.
+        ///
+        /// The panels share the shift clock, latch and MasterClr pins, so a latch reaches every
+        /// chain. A panel holds the latch while one of its rows is lit and the others wait for it.
+        /// A panel that came due in the meantime starts its slot when the latch is released,
+        /// moving its phase instead of cutting its on-time, so panels settle into turns and keep
+        /// their own refresh rates.
+        ///
+        /// On ESP32 the scans run from the esp_timer task, or from a task on the other core. Host
+        /// builds run them from poll(), or from a thread standing in for the task that sleeps until
+        /// the earliest deadline.
+        class ScanScheduler
+        {
+        public:
+            static const uint8_t MAX_PANELS = 8;
+
+            /// Called from ScanTimer::begin(). The first panel decides whether the scans run from a task.
+            bool add(ScanTimer *timer, bool task);
+            /// Stop scanning `timer`, waiting for a scan of it that is running. The last panel stops the
+            /// timer and frees every slot.
+            void remove(ScanTimer *timer);
+            /// Number of panels sharing the latch.
+            uint8_t get_panels() const { return this->count_; }
+            bool is_task() const { return this->task_; }
+
+            /// The transport of an earlier panel with the same type and data pins, nullptr if there is none.
+            OutputTransport *find_transport(OutputTransportType type, const std::vector<gpio_num_t> &data_pins) const;
+            /// Keep `transport` for the panels set up later, returns it.
+            OutputTransport *add_transport(OutputTransportType type, const std::vector<gpio_num_t> &data_pins,
+                                           std::unique_ptr<OutputTransport> transport);
+
+            /// Run the scans that are due, from loop(). Only host builds without the thread scan from here.
+            void poll();
+
+        protected:
+            friend class ScanTimer;
+
+            struct SharedTransport
+            {
+                OutputTransportType type;
+                std::vector<gpio_num_t> data_pins;
+                std::unique_ptr<OutputTransport> transport;
+            };
+
+            bool start_(bool task);
+            void stop_();
+            void dispatch_();
+            /// The running panel with the earliest deadline that may latch.
+            ScanTimer *next_() const;
+            void rearm_();
+            /// A panel was armed from outside its own scan, pick the next deadline again.
+            void wake_();
+            void hold_(ScanTimer *timer) { this->holder_ = timer; }
+            void release_(ScanTimer *timer);
+            /// Held while scans run, so remove() can wait for them.
+            void lock_scans_();
+            void unlock_scans_();
+#ifdef USE_ESP32
+            static void timer_callback_(void *arg);
+            static void task_loop_(void *arg);
+            static void task_wake_(void *arg);
+#else
+            void thread_loop_();
+#endif
+
+            ScanTimer *timers_[MAX_PANELS]{};
+            std::atomic<uint8_t> count_{0}; // slots below it are in use, read by the scanner
+            uint8_t removed_{0};
+            std::atomic<ScanTimer *> current_{nullptr}; // whose scan is running
+            std::atomic<ScanTimer *> holder_{nullptr};  // has a row lit
+            std::vector<SharedTransport> transports_;
+            bool task_{false};
+            std::atomic<bool> wake_pending_{false};
+#ifdef USE_ESP32
+            esp_timer_handle_t handle_{nullptr};
+            TaskHandle_t task_handle_{nullptr};
+            SemaphoreHandle_t scan_lock_{nullptr};
+#else
+            std::mutex scan_lock_;
+            std::mutex wake_lock_; // guards the thread's sleep against a missed wake_()
+            std::condition_variable wake_cv_;
+            bool thread_running_{false};
+            std::thread thread_;
+#endif
+        };
+
+        /// The scheduler shared by every LedDisplayComponent.
+        ScanScheduler &get_scan_scheduler();
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
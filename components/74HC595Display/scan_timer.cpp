@@ -0,0 +1,71 @@
+#include "scan_timer.h"
+#include "scan_scheduler.h"
+#include "esphome/core/hal.h"
+
+#include <algorithm>
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+        bool ScanTimer::begin(callback_t callback, void *arg, bool task)
+        {
+            this->callback_ = callback;
+            this->arg_ = arg;
+            this->deadline_.store(micros(), std::memory_order_relaxed);
+            this->retired_.store(false, std::memory_order_relaxed);
+            // add() publishes the slot, and with it the stores above
+            return get_scan_scheduler().add(this, task);
+        }
+
+        void ScanTimer::end() { get_scan_scheduler().remove(this); }
+
+        void ScanTimer::schedule_next(uint32_t interval_us)
+        {
+            uint32_t now = micros();
+            uint32_t deadline = this->deadline_.load(std::memory_order_relaxed) + interval_us;
+            int32_t delay_us = (int32_t)(deadline - now);
+            if (delay_us < 0)
+            {
+                this->missed_.fetch_add(1, std::memory_order_relaxed);
+                // We are more than a full interval behind, don't try to catch up
+                if ((uint32_t)-delay_us > interval_us)
+                    deadline = now;
+            }
+            this->deadline_.store(deadline, std::memory_order_relaxed);
+            this->arm_();
+        }
+
+        void ScanTimer::schedule_dark(uint32_t interval_us)
+        {
+            const uint32_t slip = std::min(this->slip_, interval_us);
+            this->slip_ -= slip;
+            this->schedule_next(interval_us - slip);
+        }
+
+        void ScanTimer::arm_()
+        {
+            this->running_.store(true, std::memory_order_release);
+            // From its own callback the scheduler picks the next deadline once the callback returns
+            ScanScheduler &scheduler = get_scan_scheduler();
+            if (scheduler.current_ != this)
+                scheduler.wake_();
+        }
+
+        uint32_t ScanTimer::get_lateness() const
+        {
+            int32_t late = (int32_t)(micros() - this->deadline_.load(std::memory_order_relaxed));
+            return late > 0 ? late : 0;
+        }
+
+        void ScanTimer::resync() { this->deadline_.store(micros(), std::memory_order_relaxed); }
+
+        void ScanTimer::stop() { this->running_.store(false, std::memory_order_relaxed); }
+
+        void ScanTimer::hold_latch() { get_scan_scheduler().hold_(this); }
+
+        void ScanTimer::release_latch() { get_scan_scheduler().release_(this); }
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
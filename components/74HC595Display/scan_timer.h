@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+        class ScanScheduler;
+
+        /// Deadlines of the row scan of one panel.
+        ///
+        /// The timer itself is shared: the ScanScheduler runs the callback of every panel when its
+        /// deadline comes, from the high priority timer task on ESP32 so the main loop is never
+        /// blocked by the scan, see ScanScheduler for the other ways it runs.
+        class ScanTimer
+        {
+        public:
+            using callback_t = void (*)(void *arg);
+
+            /// Register with the shared scheduler, `task` runs the scans from a task on the other core.
+            bool begin(callback_t callback, void *arg, bool task);
+            /// Unregister, the callback is not running once this returns.
+            void end();
+
+            /// Arm the timer `interval_us` after the previous deadline, so the work done in the
+            /// callback does not stretch the period. Falls back to "now" after a long stall.
+            void schedule_next(uint32_t interval_us);
+            /// schedule_next() for an interval the panel is dark, shortened to make up for the time it
+            /// last waited for the latch. That keeps the refresh rate. A new wait replaces what was
+            /// not made up for yet, so the panel never tries to catch up more than one wait.
+            void schedule_dark(uint32_t interval_us);
+
+            /// Measure the next interval from now instead of from the previous deadline.
+            void resync();
+
+            void stop();
+
+            /// Keep the other panels from latching while a row of this one is lit.
+            void hold_latch();
+            void release_latch();
+
+            /// How far past its deadline the current callback started, to be read at its start.
+            uint32_t get_lateness() const;
+            /// Number of times the timer was scheduled while already behind its deadline.
+            uint32_t get_missed() const { return this->missed_.load(std::memory_order_relaxed); }
+
+        protected:
+            friend class ScanScheduler;
+
+            void arm_();
+
+            callback_t callback_{nullptr};
+            void *arg_{nullptr};
+            // Written by the scan and, while the timer is not running, by the main loop. Setting
+            // running_ with release publishes the deadline to the scanner, which reads running_ with acquire.
+            std::atomic<uint32_t> deadline_{0};
+            std::atomic<bool> running_{false};
+            std::atomic<bool> retired_{false};
+            std::atomic<bool> waited_{false}; // came due while another panel held the latch
+            uint32_t slip_{0};    // how long it last waited, taken from the next dark intervals
+            std::atomic<uint32_t> missed_{0}; // read from the main loop
+        };
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
@@ -0,0 +1,15 @@
+#pragma once
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+        enum ScrollMode
+        {
+            CONTINUOUS = 0,
+            STOP,
+        };
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
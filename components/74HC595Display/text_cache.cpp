@@ -0,0 +1,60 @@
+#include "text_cache.h"
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+        bool TextCache::begin_frame()
+        {
+            const bool reusable = this->valid_ && this->text_only_;
+            this->current_ ^= 1;
+            this->previous_count_ = this->count_;
+            this->count_ = 0;
+            this->text_only_ = true;
+            this->valid_ = true;
+            return reusable;
+        }
+
+        const TextCache::Cell *TextCache::previous(uint16_t x) const
+        {
+            if (this->count_ >= this->previous_count_)
+                return nullptr;
+            // A cell that was partly drawn over by the one before it can not be diffed against
+            const auto &cells = this->frames_[this->current_ ^ 1];
+            const Cell &cell = cells[this->count_];
+            if (cell.x != x || (this->count_ > 0 && cell.x < cells[this->count_ - 1].end))
+                return nullptr;
+            return &cell;
+        }
+
+        void TextCache::add(uint16_t x, uint16_t end, const char *text)
+        {
+            auto &cells = this->frames_[this->current_];
+            if (this->count_ == cells.size())
+                cells.emplace_back();
+            Cell &cell = cells[this->count_++];
+            cell.x = x;
+            cell.end = end;
+            cell.text.assign(text);
+        }
+
+        void TextCache::clear()
+        {
+            this->valid_ = false;
+            this->count_ = 0;
+        }
+
+        uint16_t TextCache::extent() const
+        {
+            uint16_t extent = 0;
+            for (size_t i = 0; i < this->count_; i++)
+            {
+                if (this->get(i).end > extent)
+                    extent = this->get(i).end;
+            }
+            return extent;
+        }
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
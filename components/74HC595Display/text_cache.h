@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+        /// Remembers the text drawn by printdigit() during the last update(), so an update that
+        /// makes the same calls again only has to redraw the glyphs that changed.
+        ///
+        /// The strings of both frames are kept and reused, after the first few updates recording
+        /// a frame does not allocate.
+        class TextCache
+        {
+        public:
+            struct Cell
+            {
+                uint16_t x;
+                uint16_t end; // first column after the last glyph
+                std::string text;
+            };
+
+            /// Start recording a new frame. Returns true if the previous frame was drawn by text
+            /// calls only, so its pixels can be kept and the new calls diffed against it.
+            bool begin_frame();
+            /// The previous frame's cell for the next call, if that call drew at `x` too and was
+            /// clear of the cell before it.
+            const Cell *previous(uint16_t x) const;
+            void add(uint16_t x, uint16_t end, const char *text);
+            /// Something else than text was drawn this frame, the next one starts from scratch.
+            void set_mixed() { this->text_only_ = false; }
+            /// Forget the previous frame, for when the pixels of the text change (font, colors).
+            void clear();
+
+            /// True when this frame made as many calls as the previous one.
+            bool complete() const { return this->count_ == this->previous_count_; }
+            /// Rightmost column drawn this frame.
+            uint16_t extent() const;
+            size_t size() const { return this->count_; }
+            const Cell &get(size_t index) const { return this->frames_[this->current_][index]; }
+
+        protected:
+            std::vector<Cell> frames_[2];
+            uint8_t current_{0};
+            size_t count_{0};
+            size_t previous_count_{0};
+            bool text_only_{false};
+            bool valid_{false};
+        };
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
@@ -0,0 +1,29 @@
+#include "timeline.h"
+
+#include <algorithm>
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+        uint32_t ScrollTimeline::period() const
+        {
+            if (this->mode == ScrollMode::STOP)
+                return this->delay + (uint32_t)(this->content - this->visible) * this->speed + this->dwell;
+            return this->delay + (uint32_t)(this->content + 1) * this->speed;
+        }
+
+        uint16_t ScrollTimeline::offset(uint32_t elapsed) const
+        {
+            if (elapsed < this->delay || this->speed == 0)
+                return 0;
+            const uint32_t steps = (elapsed - this->delay) / this->speed;
+            if (this->mode == ScrollMode::STOP)
+                return std::min<uint32_t>(steps, this->content - this->visible);
+            // The last step of a continuous pass is the wrap back to column 0
+            return steps % (this->content + 1);
+        }
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+
+#include "scroll_mode.h"
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+        /// Scroll position as a function of the time since the pass started. A late caller jumps
+        /// straight to the right column instead of stepping through the ones it missed, and the
+        /// speed no longer depends on how often the main loop runs.
+        ///
+        /// A pass waits `delay` ms at column 0, then moves one column every `speed` ms. CONTINUOUS
+        /// runs the text and one gap column out to the left, STOP holds the end of the text in
+        /// view for `dwell` ms. The next pass starts at column 0 again.
+        struct ScrollTimeline
+        {
+            uint16_t content;
+            uint16_t visible;
+            ScrollMode mode;
+            uint16_t speed;
+            uint16_t delay;
+            uint16_t dwell;
+
+            /// Length of one pass in ms.
+            uint32_t period() const;
+            /// Column at the left edge `elapsed` ms into a pass, `elapsed` below period().
+            uint16_t offset(uint32_t elapsed) const;
+        };
+
+        /// How much of `span` a transition of `time` ms has covered after `elapsed` ms.
+        inline uint16_t transition_progress(uint32_t elapsed, uint16_t time, uint16_t span)
+        {
+            return elapsed >= time ? span : elapsed * span / time;
+        }
+
+        /// Whether a blinking message is in its dark half, `interval` ms per half.
+        inline bool blink_dark(uint32_t elapsed, uint16_t interval)
+        {
+            return interval != 0 && (elapsed / interval) % 2 == 1;
+        }
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
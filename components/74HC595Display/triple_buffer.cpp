@@ -0,0 +1,34 @@
+#include "triple_buffer.h"
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+        void TripleBuffer::init(uint8_t height, uint16_t width, uint8_t planes)
+        {
+            for (auto &buffer : this->buffers_)
+                buffer.init(height, width, 0, planes);
+        }
+
+        void TripleBuffer::publish()
+        {
+            // release: the reader sees the whole frame once it sees the index
+            this->published_ = this->back_;
+            this->published_at_[this->back_] = ++this->publishes_;
+            uint8_t previous = this->middle_.exchange(this->back_ | FRESH, std::memory_order_acq_rel);
+            this->back_ = previous & INDEX_MASK;
+        }
+
+        bool TripleBuffer::acquire()
+        {
+            if (!(this->middle_.load(std::memory_order_relaxed) & FRESH))
+                return false;
+            // Only the writer sets FRESH, so it can not be lost between the load and the exchange
+            uint8_t previous = this->middle_.exchange(this->front_, std::memory_order_acq_rel);
+            this->front_ = previous & INDEX_MASK;
+            return true;
+        }
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+#include "framebuffer.h"
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+
+        /// Hands complete frames from one writer to one reader without locks and without either
+        /// side ever waiting.
+        ///
+        /// The writer draws into back() and publish()es it, the reader acquire()s the newest
+        /// published frame into front(). Three buffers make sure the one being read is never the
+        /// one being written, so a frame is always shown whole. Frames published faster than
+        /// the reader acquires them are skipped, only the newest one is kept.
+        class TripleBuffer
+        {
+        public:
+            void init(uint8_t height, uint16_t width, uint8_t planes);
+
+            /// Writer side: the frame to draw next.
+            FrameBuffer &back() { return this->buffers_[this->back_]; }
+            /// Writer side: hand back() to the reader and get a free buffer as the new back().
+            void publish();
+            /// Writer side: exchange the memory of back() with `other`, which must have the same size.
+            void swap_back(FrameBuffer &other) { std::swap(this->buffers_[this->back_], other); }
+            /// Writer side: the last published frame. The reader only ever reads it, so it is
+            /// safe to read until the next publish().
+            const FrameBuffer &published() const { return this->buffers_[this->published_]; }
+            /// Writer side: publish() calls so far.
+            uint32_t get_publishes() const { return this->publishes_; }
+            /// Writer side: the publish() call that last handed back() over, 0 for none. back() still
+            /// holds that frame unless the writer changed it since.
+            uint32_t get_back_publish() const { return this->published_at_[this->back_]; }
+
+            /// Reader side: switch front() to the newest published frame.
+            /// Returns false, keeping front(), if nothing new was published since the last call.
+            bool acquire();
+            /// Reader side: the frame being shown.
+            const FrameBuffer &front() const { return this->buffers_[this->front_]; }
+
+        protected:
+            static const uint8_t INDEX_MASK = 0x03;
+            static const uint8_t FRESH = 0x04; // set by publish(), cleared by acquire()
+
+            FrameBuffer buffers_[3];
+            uint8_t back_{0};  // owned by the writer
+            uint8_t published_{1}; // owned by the writer
+            uint8_t front_{1}; // owned by the reader
+            std::atomic<uint8_t> middle_{2}; // exchanged between the two
+            uint32_t publishes_{0}; // owned by the writer
+            uint32_t published_at_[3]{}; // owned by the writer
+        };
+
+    } // namespace LedDisplay_ns
+} // namespace esphome
@@ -0,0 +1,165 @@
+// Binary code modulation: a row is lit for 1, 2, 4 and 8 units of its on-time, so brightness b
+// and a gray scale level L get b and L units per frame.
+
+#include "74HC595Display.h"
+#include "check.h"
+#include "esp32_sim.h"
+#include "shift_register_chain.h"
+#include "virtual_clock.h"
+
+#include <set>
+#include <vector>
+
+using namespace esphome;
+using namespace esphome::LedDisplay_ns;
+
+namespace
+{
+
+    const int ROW_PINS[] = {32, 33, 25, 26, 27, 14, 12};
+    const int LINES = 7;
+    const uint32_t ON_TIME = 1200;
+    const uint32_t UNIT = ON_TIME / MAX_BRIGHTNESS;
+
+    /// Lit time of every column of row 0: the row pin and the column output both on.
+    class LitTimer
+    {
+    public:
+        explicit LitTimer(sim::ShiftRegisterChain &chain) : chain_(chain), lit_us_(chain.get_length(), 0), lit_(chain.get_length(), false)
+        {
+            this->last_us_ = sim::get_clock().now_us();
+            this->listener_ = sim::add_pin_listener([this](int pin, bool level) { this->on_pin_(pin, level); });
+        }
+        ~LitTimer() { sim::remove_pin_listener(this->listener_); }
+
+        uint64_t get_lit_us(int column) const { return this->lit_us_[column]; }
+        /// Lengths of the times row 0 was switched on.
+        const std::multiset<uint32_t> &get_pulses() const { return this->pulses_; }
+
+    protected:
+        void on_pin_(int pin, bool level)
+        {
+            const uint64_t now = sim::get_clock().now_us();
+            for (size_t c = 0; c < this->lit_.size(); c++)
+            {
+                if (this->lit_[c])
+                    this->lit_us_[c] += now - this->last_us_;
+                this->lit_[c] = sim::pin_level(ROW_PINS[0]) && this->chain_.get_column(c);
+            }
+            this->last_us_ = now;
+            if (pin != ROW_PINS[0])
+                return;
+            if (level)
+                this->rise_us_ = now;
+            else
+                this->pulses_.insert(now - this->rise_us_);
+        }
+
+        sim::ShiftRegisterChain &chain_;
+        std::vector<uint64_t> lit_us_;
+        std::vector<bool> lit_;
+        std::multiset<uint32_t> pulses_;
+        uint64_t last_us_{0};
+        uint64_t rise_us_{0};
+        int listener_{0};
+    };
+
+    class TestPanel : public LedDisplayComponent
+    {
+    public:
+        using LedDisplayComponent::frames_;
+    };
+
+    void start_panel(TestPanel &panel, bool gray_scale)
+    {
+        panel.set_num_chips(1);
+        panel.set_num_chip_lines(LINES);
+        panel.set_refresh_rate(100);
+        panel.set_row_on_time(ON_TIME);
+        panel.set_gray_scale(gray_scale);
+        panel.setup();
+        CHECK(!panel.is_failed());
+    }
+
+    /// Row 0 is switched on once per set bit of the brightness, for 2^bit units.
+    void test_brightness(uint8_t brightness)
+    {
+        TestPanel panel;
+        start_panel(panel, false);
+        panel.intensity(brightness);
+        for (int x = 0; x < 8; x++)
+            panel.draw_pixel_at(x, 0);
+        panel.display();
+
+        sim::ShiftRegisterChain chain(16, 5, 17, 8);
+        sim::run_for(30000);
+        LitTimer timer(chain);
+        const uint32_t start = panel.frames_;
+        sim::run_for(500000);
+        const uint32_t frames = panel.frames_ - start;
+
+        std::set<uint32_t> expected;
+        for (int bit = 0; bit < BRIGHTNESS_BITS; bit++)
+        {
+            if (brightness & (1 << bit))
+                expected.insert((ON_TIME << bit) / MAX_BRIGHTNESS);
+        }
+        int unexpected = 0;
+        for (uint32_t pulse : timer.get_pulses())
+        {
+            auto it = expected.lower_bound(pulse > 2 ? pulse - 2 : 0);
+            if (it == expected.end() || *it > pulse + 2)
+                unexpected++;
+        }
+        if (!CHECK_EQ(unexpected, 0))
+            fprintf(stderr, "  at brightness %u\n", brightness);
+        CHECK_NEAR(timer.get_pulses().size(), expected.size() * frames, expected.size());
+        CHECK_NEAR(frames, 50u, 1u);
+        for (int x = 0; x < 8; x++)
+            CHECK_NEAR(timer.get_lit_us(x) / frames, UNIT * brightness, 3u);
+
+        panel.on_shutdown();
+    }
+
+    /// Every pixel gets the units of its own level, the global brightness scales all of them.
+    void test_gray_scale(uint8_t brightness)
+    {
+        const uint8_t levels[8] = {0, 1, 2, 3, 5, 8, 12, 15};
+        TestPanel panel;
+        start_panel(panel, true);
+        panel.intensity(brightness);
+        for (int x = 0; x < 8; x++)
+        {
+            const uint8_t value = levels[x] << 4 | levels[x];
+            panel.draw_pixel_at(x, 0, Color(value, value, value));
+        }
+        panel.display();
+
+        sim::ShiftRegisterChain chain(16, 5, 17, 8);
+        sim::run_for(30000);
+        LitTimer timer(chain);
+        const uint32_t start = panel.frames_;
+        sim::run_for(500000);
+        const uint32_t frames = panel.frames_ - start;
+
+        CHECK_NEAR(frames, 50u, 1u);
+        for (int x = 0; x < 8; x++)
+        {
+            if (!CHECK_NEAR(timer.get_lit_us(x) / frames, UNIT * levels[x] * brightness / MAX_BRIGHTNESS, 3u))
+                fprintf(stderr, "  level %u at brightness %u\n", levels[x], brightness);
+        }
+
+        panel.on_shutdown();
+    }
+
+} // namespace
+
+int main()
+{
+    // Full brightness without gray scale does not modulate, see scan_test
+    for (uint8_t brightness : {1, 5, 10, 14})
+        test_brightness(brightness);
+    test_gray_scale(15);
+    test_gray_scale(8);
+    return sim::check_result("bcm_test");
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+        namespace sim
+        {
+
+            /// `--quick` runs a short pass, for ctest.
+            inline bool is_quick(int argc, char **argv)
+            {
+                return argc > 1 && strcmp(argv[1], "--quick") == 0;
+            }
+
+            /// Wall time of one call of `body` in ns, the best of three rounds of `iterations` calls.
+            template <typename F>
+            double ns_per_call(uint32_t iterations, F &&body)
+            {
+                double best = 0;
+                for (int round = 0; round < 3; round++)
+                {
+                    const auto start = std::chrono::steady_clock::now();
+                    for (uint32_t i = 0; i < iterations; i++)
+                        body();
+                    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+                    best = round == 0 ? ns : std::min(best, ns);
+                }
+                return best / iterations;
+            }
+
+            /// Wall time of a single call of `body` in ns.
+            template <typename F>
+            double ns_once(F &&body)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                body();
+                return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            }
+
+        } // namespace sim
+    } // namespace LedDisplay_ns
+} // namespace esphome
@@ -0,0 +1,111 @@
+// Cost of the main loop side of the component on the ESP32 code paths, for num_chips 1-20 and
+// several text lengths:
+//  - update() with a writer that prints the text and a counter
+//  - display(), copying the visible window into the frame handed to the scanner
+//  - scroll_left() followed by display(), one scroll step
+//  - the longest loop() while the scan runs from the (simulated) timer, the best of several rounds
+// Times are host wall time, use them to compare changes rather than as ESP32 figures.
+
+#include "74HC595Display.h"
+#include "bench.h"
+#include "check.h"
+#include "esp32_sim.h"
+#include "virtual_clock.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace esphome;
+using namespace esphome::LedDisplay_ns;
+
+namespace
+{
+
+    class BenchPanel : public LedDisplayComponent
+    {
+    public:
+        using LedDisplayComponent::frames_;
+    };
+
+    struct Result
+    {
+        double update_us;
+        double display_us;
+        double scroll_us;
+        double loop_max_us;
+        uint32_t frames;
+    };
+
+    Result run(uint8_t chips, size_t text_length, bool quick)
+    {
+        const std::string text(text_length, 'A');
+        uint32_t counter = 0;
+
+        BenchPanel panel;
+        panel.set_num_chips(chips);
+        panel.set_num_chip_lines(7);
+        panel.set_scroll(true);
+        panel.set_scroll_speed(20);
+        panel.set_scroll_delay(0);
+        panel.set_scroll_mode(ScrollMode::CONTINUOUS);
+        panel.set_writer([&](LedDisplayComponent &it) { it.printdigitf("%s %u", text.c_str(), counter++); });
+        panel.setup();
+        CHECK(!panel.is_failed());
+
+        Result result{};
+        const uint32_t iterations = quick ? 50 : 2000;
+        result.update_us = sim::ns_per_call(iterations, [&] { panel.update(); }) / 1000;
+        result.display_us = sim::ns_per_call(iterations, [&] { panel.display(); }) / 1000;
+        result.scroll_us = sim::ns_per_call(iterations, [&] {
+                               panel.scroll_left();
+                               panel.display();
+                           }) / 1000;
+
+        // Rounds of one second of loops 1 ms apart with an update every 100 ms, the timer scans the rows
+        // in between. A single slow loop() is mostly host noise, so the lowest maximum of the rounds is kept.
+        const uint32_t frames = panel.frames_;
+        const uint32_t rounds = quick ? 3 : 10;
+        const uint32_t loops = quick ? 200 : 1000;
+        double loop_max = 0;
+        for (uint32_t round = 0; round < rounds; round++)
+        {
+            const uint64_t start = sim::get_clock().now_us();
+            double round_max = 0;
+            for (uint32_t ms = 0; ms < loops; ms++)
+            {
+                sim::run_until(start + (ms + 1) * 1000ULL);
+                if (ms % 100 == 0)
+                    panel.update();
+                round_max = std::max(round_max, sim::ns_once([&] { panel.loop(); }));
+            }
+            loop_max = round == 0 ? round_max : std::min(loop_max, round_max);
+        }
+        result.loop_max_us = loop_max / 1000;
+        result.frames = (panel.frames_ - frames) / rounds;
+        CHECK(result.frames > 0);
+
+        panel.on_shutdown();
+        return result;
+    }
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const bool quick = sim::is_quick(argc, argv);
+    const std::vector<uint8_t> chip_counts = quick ? std::vector<uint8_t>{1, 5, 20} : std::vector<uint8_t>{1, 2, 4, 5, 8, 10, 12, 16, 20};
+    const std::vector<size_t> text_lengths = quick ? std::vector<size_t>{8, 128} : std::vector<size_t>{8, 32, 128};
+
+    printf("%5s %6s %14s %12s %13s %12s %8s\n", "chips", "text", "update() us", "display() us", "scroll us", "loop() max us", "frames");
+    for (uint8_t chips : chip_counts)
+    {
+        for (size_t length : text_lengths)
+        {
+            const Result r = run(chips, length, quick);
+            printf("%5u %6u %14.2f %12.2f %13.2f %12.2f %8u\n", chips, (unsigned)length, r.update_us, r.display_us, r.scroll_us,
+                   r.loop_max_us, r.frames);
+        }
+    }
+    return sim::check_result("display_bench");
+}
@@ -0,0 +1,92 @@
+// Characters rendered per second by the text path, for both fonts and several text lengths:
+//  - printdigit() on its own, laying out every glyph into the canvas
+//  - update() with a writer printing text of which one character changes every call, the text
+//    cache only redraws that glyph
+//  - update() with a writer printing the same text, which the text cache keeps
+// Times are host wall time, use them to compare changes rather than as ESP32 figures.
+
+#include "74HC595Display.h"
+#include "bench.h"
+#include "check.h"
+#include "esp32_sim.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace esphome;
+using namespace esphome::LedDisplay_ns;
+
+namespace
+{
+
+    struct Result
+    {
+        double printdigit_mcps;
+        double changing_mcps;
+        double same_mcps;
+    };
+
+    /// Millions of characters per second for `length` characters taking `ns`.
+    double mcps(size_t length, double ns) { return length / ns * 1000.0; }
+
+    Result run(TextFont font, size_t length, bool quick)
+    {
+        std::string text;
+        for (size_t i = 0; i < length; i++)
+            text += (char)('A' + i % 26);
+        bool changing = true;
+        uint32_t counter = 0;
+
+        LedDisplayComponent panel;
+        panel.set_num_chips(10);
+        panel.set_num_chip_lines(7);
+        panel.set_font(font);
+        panel.set_scroll(true);
+        panel.set_writer([&](LedDisplayComponent &it) {
+            // a changing text replaces one character per call, the width stays the same
+            if (changing)
+            {
+                counter++;
+                text[counter % length] = (char)('A' + counter % 26);
+            }
+            it.printdigit(text.c_str());
+        });
+        panel.setup();
+        CHECK(!panel.is_failed());
+
+        Result result{};
+        const uint32_t iterations = quick ? 50 : 5000;
+        result.printdigit_mcps = mcps(length, sim::ns_per_call(iterations, [&] { panel.printdigit(text.c_str()); }));
+        result.changing_mcps = mcps(length, sim::ns_per_call(iterations, [&] { panel.update(); }));
+        changing = false;
+        panel.update();
+        result.same_mcps = mcps(length, sim::ns_per_call(iterations, [&] { panel.update(); }));
+
+        panel.on_shutdown();
+        return result;
+    }
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const bool quick = sim::is_quick(argc, argv);
+    const std::vector<size_t> text_lengths = quick ? std::vector<size_t>{8, 128} : std::vector<size_t>{1, 8, 32, 128};
+    const struct
+    {
+        TextFont font;
+        const char *name;
+    } fonts[] = {{FONT_5X7, "5x7"}, {FONT_5X7_PROPORTIONAL, "prop"}};
+
+    printf("%5s %6s %22s %22s %20s\n", "font", "text", "printdigit() Mchar/s", "update() new Mchar/s", "update() same Mchar/s");
+    for (const auto &font : fonts)
+    {
+        for (size_t length : text_lengths)
+        {
+            const Result r = run(font.font, length, quick);
+            printf("%5s %6u %22.2f %22.2f %20.2f\n", font.name, (unsigned)length, r.printdigit_mcps, r.changing_mcps, r.same_mcps);
+        }
+    }
+    return sim::check_result("text_bench");
+}
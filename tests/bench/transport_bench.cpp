@@ -0,0 +1,89 @@
+// Time one row takes in OutputTransport::shift_row() for num_chips 1-20, per backend:
+//  - GPIO, bit-banging one data line
+//  - SPI at the default 8 MHz data rate
+//  - PARALLEL with 2-8 chains, "-" where the chips do not split evenly over the chains
+// Times are on the virtual clock: the delays and SPI transfers as programmed, plus 100 ns for every
+// gpio_set_level() and 25 ns for every GPIO_OUT register write, about what they take on an ESP32
+// at 240 MHz. The DMA buffer copy of the SPI backend is not counted.
+
+#include "bench.h"
+#include "check.h"
+#include "esp32_sim.h"
+#include "framebuffer.h"
+#include "output_transport.h"
+#include "virtual_clock.h"
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+using namespace esphome;
+using namespace esphome::LedDisplay_ns;
+
+namespace
+{
+
+    const gpio_num_t DATA_PIN = (gpio_num_t)16;
+    const gpio_num_t CLOCK_PIN = (gpio_num_t)5;
+    const gpio_num_t LATCH_PIN = (gpio_num_t)17;
+    const gpio_num_t CHAIN_PINS[] = {(gpio_num_t)16, (gpio_num_t)4, (gpio_num_t)13, (gpio_num_t)15,
+                                     (gpio_num_t)19, (gpio_num_t)21, (gpio_num_t)22, (gpio_num_t)23};
+    const uint32_t SPI_RATE = 8000000;
+
+    /// Virtual µs per row, averaged over `rows` shifts of a checkerboard row.
+    double us_per_row(OutputTransport &transport, uint16_t bits, uint32_t rows)
+    {
+        std::vector<uint32_t> row(FrameBuffer::words_for(bits), 0xAAAAAAAA);
+        const uint64_t start = sim::get_clock().now_us();
+        for (uint32_t i = 0; i < rows; i++)
+            transport.shift_row(row.data(), bits);
+        return double(sim::get_clock().now_us() - start) / rows;
+    }
+
+    double run(OutputTransport *transport, uint16_t bits, uint32_t rows)
+    {
+        std::unique_ptr<OutputTransport> owned(transport);
+        CHECK(owned->setup());
+        return us_per_row(*owned, bits, rows);
+    }
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const bool quick = sim::is_quick(argc, argv);
+    const uint32_t rows = quick ? 20 : 500;
+    std::vector<uint8_t> chip_counts;
+    if (quick)
+        chip_counts = {1, 8, 20};
+    else
+        for (uint8_t chips = 1; chips <= 20; chips++)
+            chip_counts.push_back(chips);
+
+    sim::set_write_costs(100, 25);
+
+    printf("%5s %9s %9s", "chips", "GPIO us", "SPI us");
+    for (int chains = 2; chains <= 8; chains++)
+        printf("   PAR%u us", chains);
+    printf("\n");
+    for (uint8_t chips : chip_counts)
+    {
+        const uint16_t bits = chips * 8;
+        printf("%5u %9.2f %9.2f", chips, run(new GpioTransport(DATA_PIN, CLOCK_PIN, LATCH_PIN), bits, rows),
+               run(new SpiTransport(DATA_PIN, CLOCK_PIN, LATCH_PIN, SPI_RATE, bits), bits, rows));
+        for (int chains = 2; chains <= 8; chains++)
+        {
+            if (chips % chains != 0)
+            {
+                printf(" %9s", "-");
+                continue;
+            }
+            std::vector<gpio_num_t> pins(CHAIN_PINS, CHAIN_PINS + chains);
+            printf(" %9.2f", run(new ParallelGpioTransport(pins, CLOCK_PIN, LATCH_PIN), bits, rows));
+        }
+        printf("\n");
+    }
+
+    sim::set_write_costs(0, 0);
+    return sim::check_result("transport_bench");
+}
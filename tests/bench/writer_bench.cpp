@@ -0,0 +1,114 @@
+// Cost of a typical writer lambda, drawn with the span based calls of the component and with the
+// per-pixel DisplayBuffer defaults they replace, for num_chips 1-20. The writer clears the canvas,
+// draws a border, a progress bar and a 16x7 icon. Both draw the same frame.
+// Times are host wall time, use them to compare changes rather than as ESP32 figures.
+
+#include "74HC595Display.h"
+#include "bench.h"
+#include "check.h"
+#include "esp32_sim.h"
+
+#include <cstdio>
+#include <vector>
+
+using namespace esphome;
+using namespace esphome::LedDisplay_ns;
+
+namespace
+{
+
+    // An arrow, 16x7, one byte per 8 columns
+    const uint8_t ICON[] = {0x00, 0x80, 0x00, 0xC0, 0xFF, 0xE0, 0xFF, 0xF0, 0xFF, 0xE0, 0x00, 0xC0, 0x00, 0x80};
+
+    class BenchPanel : public LedDisplayComponent
+    {
+    public:
+        uint32_t get_hash() { return this->buffer_.hash(); }
+    };
+
+    void draw_spans(LedDisplayComponent &it, display::Image &icon, int progress)
+    {
+        const int width = it.get_width();
+        it.fill(COLOR_OFF);
+        it.horizontal_line(0, 0, width);
+        it.horizontal_line(0, 6, width);
+        it.vertical_line(0, 0, 7);
+        it.vertical_line(width - 1, 0, 7);
+        it.filled_rectangle(18, 2, progress, 3);
+        it.image(1, 0, &icon);
+    }
+
+    void draw_pixels(LedDisplayComponent &it, display::Image &icon, int progress)
+    {
+        // The base class versions, every pixel through draw_absolute_pixel_internal()
+        const int width = it.get_width();
+        display::DisplayBuffer &base = it;
+        base.DisplayBuffer::fill(COLOR_OFF);
+        base.DisplayBuffer::horizontal_line(0, 0, width);
+        base.DisplayBuffer::horizontal_line(0, 6, width);
+        base.DisplayBuffer::vertical_line(0, 0, 7);
+        base.DisplayBuffer::vertical_line(width - 1, 0, 7);
+        base.DisplayBuffer::filled_rectangle(18, 2, progress, 3);
+        base.DisplayBuffer::image(1, 0, &icon);
+    }
+
+    struct Result
+    {
+        double spans_us;
+        double pixels_us;
+    };
+
+    Result run(uint8_t chips, bool quick)
+    {
+        display::Image icon(ICON, 16, 7);
+        bool spans = true;
+        int progress = 0;
+
+        BenchPanel panel;
+        panel.set_num_chips(chips);
+        panel.set_num_chip_lines(7);
+        panel.set_scroll(false);
+        panel.set_writer([&](LedDisplayComponent &it) {
+            // the bar grows every call so the frame always changes
+            const int bar = progress++ % std::max(1, it.get_width() - 20);
+            if (spans)
+                draw_spans(it, icon, bar);
+            else
+                draw_pixels(it, icon, bar);
+        });
+        panel.setup();
+        CHECK(!panel.is_failed());
+
+        // Both draw the same
+        panel.update();
+        const uint32_t hash = panel.get_hash();
+        spans = false;
+        progress = 0;
+        panel.update();
+        CHECK_EQ(panel.get_hash(), hash);
+
+        Result result{};
+        const uint32_t iterations = quick ? 50 : 5000;
+        result.pixels_us = sim::ns_per_call(iterations, [&] { panel.update(); }) / 1000;
+        spans = true;
+        result.spans_us = sim::ns_per_call(iterations, [&] { panel.update(); }) / 1000;
+
+        panel.on_shutdown();
+        return result;
+    }
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const bool quick = sim::is_quick(argc, argv);
+    const std::vector<uint8_t> chip_counts = quick ? std::vector<uint8_t>{1, 20} : std::vector<uint8_t>{1, 2, 5, 10, 20};
+
+    printf("%5s %15s %15s %8s\n", "chips", "per-pixel us", "spans us", "speedup");
+    for (uint8_t chips : chip_counts)
+    {
+        const Result r = run(chips, quick);
+        printf("%5u %15.2f %15.2f %7.1fx\n", chips, r.pixels_us, r.spans_us, r.pixels_us / r.spans_us);
+    }
+    return sim::check_result("writer_bench");
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+
+#include "esphome/core/component.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+
+// Stand-in for esphome/components/display/display_buffer.h. The drawing calls go pixel by pixel
+// through draw_pixel_at() like the real DisplayBuffer does, so the benchmarks compare against it.
+
+namespace esphome
+{
+
+    struct Color
+    {
+        Color() = default;
+        Color(uint8_t red, uint8_t green, uint8_t blue, uint8_t white = 0) : red(red), green(green), blue(blue), white(white) {}
+
+        bool is_on() const { return (this->red | this->green | this->blue | this->white) != 0; }
+
+        uint8_t red{0};
+        uint8_t green{0};
+        uint8_t blue{0};
+        uint8_t white{0};
+    };
+
+    static const Color COLOR_OFF(0, 0, 0, 0);
+    static const Color COLOR_ON(255, 255, 255, 255);
+
+    namespace display
+    {
+
+        enum DisplayRotation
+        {
+            DISPLAY_ROTATION_0_DEGREES = 0,
+            DISPLAY_ROTATION_90_DEGREES = 90,
+            DISPLAY_ROTATION_180_DEGREES = 180,
+            DISPLAY_ROTATION_270_DEGREES = 270,
+        };
+
+        enum ImageType
+        {
+            IMAGE_TYPE_BINARY = 0,
+            IMAGE_TYPE_GRAYSCALE = 1,
+        };
+
+        /// A 1 bit image, rows padded to whole bytes, the leftmost pixel in the MSB.
+        class Image
+        {
+        public:
+            Image(const uint8_t *data, int width, int height, ImageType type = IMAGE_TYPE_BINARY)
+                : data_(data), width_(width), height_(height), type_(type) {}
+
+            bool get_pixel(int x, int y) const
+            {
+                if (x < 0 || x >= this->width_ || y < 0 || y >= this->height_)
+                    return false;
+                const int width_8 = ((this->width_ + 7) / 8) * 8;
+                const int pos = x + y * width_8;
+                return progmem_read_byte(this->data_ + pos / 8) & (0x80 >> (pos % 8));
+            }
+            int get_width() const { return this->width_; }
+            int get_height() const { return this->height_; }
+            ImageType get_type() const { return this->type_; }
+
+        protected:
+            const uint8_t *data_;
+            int width_;
+            int height_;
+            ImageType type_;
+        };
+
+        class DisplayBuffer
+        {
+        public:
+            virtual ~DisplayBuffer() = default;
+
+            virtual void fill(Color color) { this->filled_rectangle(0, 0, this->get_width(), this->get_height(), color); }
+            void clear() { this->fill(COLOR_OFF); }
+
+            int get_width() { return this->get_width_internal(); }
+            int get_height() { return this->get_height_internal(); }
+            void set_rotation(DisplayRotation rotation) { this->rotation_ = rotation; }
+
+            void draw_pixel_at(int x, int y, Color color = COLOR_ON)
+            {
+                switch (this->rotation_)
+                {
+                case DISPLAY_ROTATION_0_DEGREES:
+                    break;
+                case DISPLAY_ROTATION_90_DEGREES:
+                    std::swap(x, y);
+                    x = this->get_width_internal() - x - 1;
+                    break;
+                case DISPLAY_ROTATION_180_DEGREES:
+                    x = this->get_width_internal() - x - 1;
+                    y = this->get_height_internal() - y - 1;
+                    break;
+                case DISPLAY_ROTATION_270_DEGREES:
+                    std::swap(x, y);
+                    y = this->get_height_internal() - y - 1;
+                    break;
+                }
+                this->draw_absolute_pixel_internal(x, y, color);
+            }
+
+            void line(int x1, int y1, int x2, int y2, Color color = COLOR_ON)
+            {
+                const int dx = std::abs(x2 - x1), sx = x1 < x2 ? 1 : -1;
+                const int dy = -std::abs(y2 - y1), sy = y1 < y2 ? 1 : -1;
+                int err = dx + dy;
+                while (true)
+                {
+                    this->draw_pixel_at(x1, y1, color);
+                    if (x1 == x2 && y1 == y2)
+                        break;
+                    const int e2 = 2 * err;
+                    if (e2 >= dy)
+                    {
+                        err += dy;
+                        x1 += sx;
+                    }
+                    if (e2 <= dx)
+                    {
+                        err += dx;
+                        y1 += sy;
+                    }
+                }
+            }
+            void horizontal_line(int x, int y, int width, Color color = COLOR_ON)
+            {
+                for (int i = x; i < x + width; i++)
+                    this->draw_pixel_at(i, y, color);
+            }
+            void vertical_line(int x, int y, int height, Color color = COLOR_ON)
+            {
+                for (int i = y; i < y + height; i++)
+                    this->draw_pixel_at(x, i, color);
+            }
+            void rectangle(int x1, int y1, int width, int height, Color color = COLOR_ON)
+            {
+                this->horizontal_line(x1, y1, width, color);
+                this->horizontal_line(x1, y1 + height - 1, width, color);
+                this->vertical_line(x1, y1, height, color);
+                this->vertical_line(x1 + width - 1, y1, height, color);
+            }
+            void filled_rectangle(int x1, int y1, int width, int height, Color color = COLOR_ON)
+            {
+                for (int i = y1; i < y1 + height; i++)
+                    this->horizontal_line(x1, i, width, color);
+            }
+            void image(int x, int y, Image *image, Color color_on = COLOR_ON, Color color_off = COLOR_OFF)
+            {
+                for (int img_x = 0; img_x < image->get_width(); img_x++)
+                {
+                    for (int img_y = 0; img_y < image->get_height(); img_y++)
+                        this->draw_pixel_at(x + img_x, y + img_y, image->get_pixel(img_x, img_y) ? color_on : color_off);
+                }
+            }
+
+            virtual int get_width_internal() = 0;
+            virtual int get_height_internal() = 0;
+            virtual void draw_absolute_pixel_internal(int x, int y, Color color) = 0;
+
+        protected:
+            DisplayRotation rotation_{DISPLAY_ROTATION_0_DEGREES};
+        };
+
+    } // namespace display
+} // namespace esphome
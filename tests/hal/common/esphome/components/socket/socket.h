@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstring>
+#include <memory>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Stand-in for esphome/components/socket/socket.h on top of the BSD sockets of Linux.
+
+namespace esphome
+{
+    namespace socket
+    {
+
+        class Socket
+        {
+        public:
+            explicit Socket(int fd) : fd_(fd) {}
+            ~Socket() { this->close(); }
+
+            int bind(const struct sockaddr *addr, socklen_t addrlen) { return ::bind(this->fd_, addr, addrlen); }
+            ssize_t read(void *buf, size_t len) { return ::read(this->fd_, buf, len); }
+            ssize_t readv(const struct iovec *iov, int iovcnt) { return ::readv(this->fd_, iov, iovcnt); }
+            int setblocking(bool blocking)
+            {
+                const int flags = ::fcntl(this->fd_, F_GETFL, 0);
+                return ::fcntl(this->fd_, F_SETFL, blocking ? flags & ~O_NONBLOCK : flags | O_NONBLOCK);
+            }
+            int close()
+            {
+                if (this->fd_ < 0)
+                    return 0;
+                const int ret = ::close(this->fd_);
+                this->fd_ = -1;
+                return ret;
+            }
+
+        protected:
+            int fd_;
+        };
+
+        inline std::unique_ptr<Socket> socket(int domain, int type, int protocol)
+        {
+            const int fd = ::socket(domain, type, protocol);
+            if (fd < 0)
+                return nullptr;
+            return std::unique_ptr<Socket>(new Socket(fd));
+        }
+
+        inline std::unique_ptr<Socket> socket_ip(int type, int protocol) { return socket(AF_INET, type, protocol); }
+
+        inline socklen_t set_sockaddr_any(struct sockaddr *addr, socklen_t addrlen, uint16_t port)
+        {
+            if (addrlen < sizeof(struct sockaddr_in))
+                return 0;
+            auto *server = reinterpret_cast<struct sockaddr_in *>(addr);
+            memset(server, 0, sizeof(struct sockaddr_in));
+            server->sin_family = AF_INET;
+            server->sin_addr.s_addr = htonl(INADDR_ANY);
+            server->sin_port = htons(port);
+            return sizeof(struct sockaddr_in);
+        }
+
+    } // namespace socket
+} // namespace esphome
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+// Stand-in for the ESPTime of esphome/components/time/real_time_clock.h.
+
+namespace esphome
+{
+    namespace time
+    {
+
+        struct ESPTime
+        {
+            uint8_t second;
+            uint8_t minute;
+            uint8_t hour;
+            uint8_t day_of_week; // 1 is Sunday
+            uint8_t day_of_month;
+            uint16_t day_of_year;
+            uint8_t month; // 1 is January
+            uint16_t year;
+
+            size_t strftime(char *buffer, size_t buffer_len, const char *format)
+            {
+                struct tm c_tm = {};
+                c_tm.tm_sec = this->second;
+                c_tm.tm_min = this->minute;
+                c_tm.tm_hour = this->hour;
+                c_tm.tm_wday = this->day_of_week - 1;
+                c_tm.tm_mday = this->day_of_month;
+                c_tm.tm_yday = this->day_of_year - 1;
+                c_tm.tm_mon = this->month - 1;
+                c_tm.tm_year = this->year - 1900;
+                return ::strftime(buffer, buffer_len, format, &c_tm);
+            }
+        };
+
+    } // namespace time
+} // namespace esphome
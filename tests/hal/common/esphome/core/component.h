@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+
+// Stand-in for the parts of esphome/core/component.h the component uses.
+
+namespace esphome
+{
+
+    namespace setup_priority
+    {
+        static const float HARDWARE = 800.0f;
+        static const float PROCESSOR = 400.0f;
+    } // namespace setup_priority
+
+    class Component
+    {
+    public:
+        virtual ~Component() = default;
+
+        virtual void setup() {}
+        virtual void loop() {}
+        virtual void dump_config() {}
+        virtual void on_shutdown() {}
+        virtual float get_setup_priority() const { return 0.0f; }
+
+        void mark_failed() { this->failed_ = true; }
+        bool is_failed() const { return this->failed_; }
+        void status_set_warning() {}
+        void status_clear_warning() {}
+
+    protected:
+        bool failed_{false};
+    };
+
+    class PollingComponent : public Component
+    {
+    public:
+        PollingComponent() = default;
+        explicit PollingComponent(uint32_t update_interval) : update_interval_(update_interval) {}
+
+        virtual void update() = 0;
+
+        void set_update_interval(uint32_t update_interval) { this->update_interval_ = update_interval; }
+        uint32_t get_update_interval() const { return this->update_interval_; }
+
+    protected:
+        uint32_t update_interval_{1000};
+    };
+
+} // namespace esphome
+
+#define LOG_UPDATE_INTERVAL(this)
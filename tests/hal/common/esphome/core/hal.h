@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+// Stand-in for esphome/core/hal.h. The time functions run on the virtual clock, see sim/virtual_clock.h.
+
+#define HOT
+#define IRAM_ATTR
+#define ALWAYS_INLINE inline
+#define PROGMEM
+
+namespace esphome
+{
+
+    uint32_t millis();
+    uint32_t micros();
+    void delay(uint32_t ms);
+    void delayMicroseconds(uint32_t us);
+
+    inline uint8_t progmem_read_byte(const uint8_t *addr) { return *addr; }
+
+} // namespace esphome
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "esphome/core/optional.h"
+
+// Stand-in for the parts of esphome/core/helpers.h the component uses.
+
+namespace esphome
+{
+
+    inline uint32_t fnv1_hash(const std::string &str)
+    {
+        uint32_t hash = 2166136261UL;
+        for (char c : str)
+        {
+            hash *= 16777619UL;
+            hash ^= c;
+        }
+        return hash;
+    }
+
+} // namespace esphome
+
+#define YESNO(b) ((b) ? "YES" : "NO")
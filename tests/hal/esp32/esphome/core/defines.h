@@ -0,0 +1,6 @@
+#pragma once
+
+// ESP32 build, the ESP-IDF calls go to the simulator in sim/esp32_sim.cpp
+#define USE_ESP32
+#define USE_SENSOR
+#define USE_TIME
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+// Stand-in for the FreeRTOS types and constants the component uses.
+
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void *TaskHandle_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdFAIL pdFALSE
+#define pdPASS pdTRUE
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFUL)
+#define portNUM_PROCESSORS 2
+#define configMAX_PRIORITIES 25
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+inline BaseType_t xPortGetCoreID() { return 1; }
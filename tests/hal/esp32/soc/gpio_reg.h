@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+
+// Stand-in for soc/gpio_reg.h, the output set and clear registers of GPIO0-31 go to the simulator.
+
+#define GPIO_OUT_W1TS_REG 0x3FF44008
+#define GPIO_OUT_W1TC_REG 0x3FF4400C
+
+void sim_reg_write(uint32_t reg, uint32_t value);
+
+#define REG_WRITE(_r, _v) sim_reg_write((_r), (_v))
@@ -0,0 +1,8 @@
+#pragma once
+
+// ESPHome host platform build
+#define USE_HOST
+#define USE_SENSOR
+#define USE_TIME
+// as generated for a panel with an ingest: block, see display.py
+#define USE_LED_DISPLAY_INGEST
@@ -0,0 +1,72 @@
+// Hammers the hand-off between the main loop and the scan thread of the host build: two panels
+// scanned from the thread while the main thread redraws, toggles brightness, inversion and power.
+// Configure with -DLED_DISPLAY_SANITIZER=thread to have ThreadSanitizer check every access.
+
+#include "74HC595Display.h"
+#include "check.h"
+#include "virtual_clock.h"
+
+#include <chrono>
+
+using namespace esphome;
+using namespace esphome::LedDisplay_ns;
+
+namespace
+{
+
+    class TestPanel : public LedDisplayComponent
+    {
+    public:
+        using LedDisplayComponent::frames_;
+    };
+
+} // namespace
+
+int main()
+{
+    // The scan thread sleeps until its deadlines, so the clock has to run by itself
+    sim::get_clock().follow_real_time(true);
+
+    TestPanel a, b;
+    a.set_num_chips(4);
+    a.set_num_chip_lines(7);
+    a.set_scan_task(true);
+    a.set_gray_scale(true);
+    a.set_refresh_rate(100);
+    b.set_num_chips(2);
+    b.set_num_chip_lines(5);
+    b.set_row_pins({2, 4, 13, 15, 19});
+    b.set_scan_task(true);
+    b.set_refresh_rate(150);
+    a.setup();
+    b.setup();
+    CHECK(!a.is_failed() && !b.is_failed());
+
+    uint32_t i = 0;
+    const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(1500);
+    while (std::chrono::steady_clock::now() < end)
+    {
+        i++;
+        a.printdigitf("%u", i);
+        a.update();
+        a.loop();
+        a.intensity(i % 16);
+        b.printdigitf("%u", i);
+        b.update();
+        b.loop();
+        if (i % 64 == 0)
+            b.invert_on_off();
+        if (i % 1000 == 0)
+            a.turn_on_off(!a.is_on());
+    }
+    a.turn_on_off(true);
+
+    // Both kept scanning while all of that went on
+    CHECK(a.frames_ > 20);
+    CHECK(b.frames_ > 50);
+
+    a.on_shutdown();
+    b.on_shutdown();
+    sim::get_clock().follow_real_time(false);
+    return sim::check_result("handoff_stress_test");
+}
@@ -0,0 +1,36 @@
+// Durations land in power of two buckets and the summary names only the buckets that counted.
+
+#include "histogram.h"
+#include "check.h"
+
+#include <cstring>
+#include <initializer_list>
+
+using namespace esphome::LedDisplay_ns;
+
+int main()
+{
+    TimingHistogram histogram;
+    char text[160];
+    histogram.format(text, sizeof(text));
+    CHECK(strcmp(text, "-") == 0);
+
+    for (uint32_t us : {0u, 1u, 40u, 63u, 64u, 100000u})
+        histogram.add(us);
+    CHECK_EQ(histogram.get_count(0), 1u);
+    CHECK_EQ(histogram.get_count(1), 1u);
+    CHECK_EQ(histogram.get_count(6), 2u);
+    CHECK_EQ(histogram.get_count(7), 1u);
+    CHECK_EQ(histogram.get_count(TimingHistogram::BUCKETS - 1), 1u);
+    CHECK_EQ(histogram.get_total(), 6u);
+
+    histogram.format(text, sizeof(text));
+    if (!CHECK(strcmp(text, "<1us 1, <2us 1, <64us 2, <128us 1, >=16384us 1") == 0))
+        fprintf(stderr, "  got \"%s\"\n", text);
+    // A short buffer is cut off, never overrun
+    char small[12];
+    histogram.format(small, sizeof(small));
+    CHECK(strlen(small) < sizeof(small));
+
+    return esphome::LedDisplay_ns::sim::check_result("histogram_test");
+}
@@ -0,0 +1,288 @@
+// Frames sent over UDP to 127.0.0.1 reach the scanned frame, in sequence order: late frames are
+// skipped, gaps and malformed datagrams count as dropped, and the drawn content comes back once
+// the sender goes quiet. Rectangles only change their own pixels and are cut off at the edges,
+// brightness levels reach the planes of a gray scale panel.
+
+#include "74HC595Display.h"
+#include "check.h"
+#include "virtual_clock.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+using namespace esphome;
+using namespace esphome::LedDisplay_ns;
+
+namespace
+{
+
+    const int LINES = 7;
+    const int COLUMNS = 16;
+
+    class TestPanel : public LedDisplayComponent
+    {
+    public:
+        using LedDisplayComponent::ingest_;
+        using LedDisplayComponent::ingest_active_;
+        using LedDisplayComponent::scan_frames_;
+
+        /// Columns 0-15 of the frame the scanner shows.
+        uint16_t scanned_row(int y, int plane = 0) const { return this->scan_frames_.front().row(y, plane)[0] & 0xFFFF; }
+    };
+
+    /// Loops 1 ms apart, the host build scans from loop()
+    void run_ms(TestPanel &panel, uint32_t ms)
+    {
+        for (uint32_t i = 0; i < ms; i++)
+        {
+            sim::get_clock().advance_us(1000);
+            panel.loop();
+        }
+    }
+
+    class Sender
+    {
+    public:
+        explicit Sender(uint16_t port) : fd_(::socket(AF_INET, SOCK_DGRAM, 0))
+        {
+            memset(&this->to_, 0, sizeof(this->to_));
+            this->to_.sin_family = AF_INET;
+            this->to_.sin_port = htons(port);
+            this->to_.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        }
+        ~Sender() { ::close(this->fd_); }
+
+        /// A whole display frame, row y taking the 16 bits of `rows[y]`.
+        void frame(uint32_t sequence, const uint16_t rows[LINES], const char *magic = "LD", int extra = 0)
+        {
+            IngestHeader header{};
+            header.magic[0] = magic[0];
+            header.magic[1] = magic[1];
+            header.sequence = sequence;
+            this->send(header, std::vector<uint32_t>(rows, rows + LINES), extra);
+        }
+
+        /// A rectangle, `words` holding its rows one word each (width up to 32), plane after plane.
+        void rect(uint32_t sequence, uint16_t x, uint16_t y, uint16_t width, uint16_t height, const std::vector<uint32_t> &words,
+                  uint8_t flags = 0, int extra = 0)
+        {
+            IngestHeader header{};
+            header.magic[0] = 'L';
+            header.magic[1] = 'D';
+            header.flags = flags;
+            header.sequence = sequence;
+            header.x = x;
+            header.y = y;
+            header.width = width;
+            header.height = height;
+            this->send(header, words, extra);
+        }
+
+        /// `header` and `words`, with `extra` zero bytes more or (if negative) fewer.
+        void send(const IngestHeader &header, const std::vector<uint32_t> &words, int extra)
+        {
+            std::vector<uint8_t> datagram(sizeof(header) + words.size() * sizeof(uint32_t) + extra, 0);
+            memcpy(datagram.data(), &header, sizeof(header));
+            memcpy(datagram.data() + sizeof(header), words.data(), std::min(datagram.size() - sizeof(header), words.size() * sizeof(uint32_t)));
+            ::sendto(this->fd_, datagram.data(), datagram.size(), 0, (const sockaddr *)&this->to_, sizeof(this->to_));
+        }
+
+    protected:
+        int fd_;
+        sockaddr_in to_;
+    };
+
+    bool scanned(const TestPanel &panel, const uint16_t rows[LINES])
+    {
+        for (int y = 0; y < LINES; y++)
+        {
+            if (panel.scanned_row(y) != rows[y])
+                return false;
+        }
+        return true;
+    }
+
+    /// What a one plane rectangle does to `rows`: its `words` are placed at x, y, cut off at the edges.
+    void apply_rect(uint16_t rows[LINES], int x, int y, int width, int height, const std::vector<uint32_t> &words)
+    {
+        for (int row = 0; row < height && y + row < LINES; row++)
+        {
+            for (int column = 0; column < width && x + column < COLUMNS; column++)
+            {
+                const uint16_t bit = 1 << (x + column);
+                rows[y + row] = (words[row] >> column) & 1 ? rows[y + row] | bit : rows[y + row] & ~bit;
+            }
+        }
+    }
+
+    void start_panel(TestPanel &panel, uint16_t port, bool gray_scale)
+    {
+        panel.set_num_chips(COLUMNS / 8);
+        panel.set_num_chip_lines(LINES);
+        panel.set_gray_scale(gray_scale);
+        panel.set_ingest_port(port);
+        panel.set_ingest_timeout(100);
+        panel.setup();
+        CHECK(!panel.is_failed());
+        panel.display();
+        // The first loop opens the socket
+        run_ms(panel, 1);
+        CHECK(panel.ingest_.is_ready());
+    }
+
+    void test_sequence(uint16_t port)
+    {
+        const uint16_t first[LINES] = {0x0001, 0x0003, 0x0007, 0x000F, 0x001F, 0x003F, 0x007F};
+        const uint16_t second[LINES] = {0x8000, 0x4000, 0x2000, 0x1000, 0x0800, 0x0400, 0x0200};
+        const uint16_t blank[LINES] = {};
+
+        TestPanel panel;
+        start_panel(panel, port, false);
+        Sender sender(port);
+
+        sender.frame(1, first);
+        run_ms(panel, 20);
+        CHECK(panel.ingest_active_);
+        CHECK(scanned(panel, first));
+
+        // Not newer than the last one: late, not shown
+        sender.frame(1, second);
+        run_ms(panel, 20);
+        CHECK_EQ(panel.ingest_.get_late(), 1u);
+        CHECK(scanned(panel, first));
+
+        // Frames 2 and 3 never came
+        sender.frame(4, second);
+        run_ms(panel, 20);
+        CHECK(scanned(panel, second));
+        CHECK_EQ(panel.ingest_.get_dropped(), 2u);
+
+        // A wrong magic or payload size is dropped
+        sender.frame(5, first, "XX");
+        sender.frame(6, first, "LD", 4);
+        run_ms(panel, 20);
+        CHECK(scanned(panel, second));
+        CHECK_EQ(panel.ingest_.get_dropped(), 4u);
+
+        // Quiet for longer than the timeout: the drawn (blank) content is back, and any sequence
+        // number is taken again
+        run_ms(panel, 120);
+        CHECK(!panel.ingest_active_);
+        CHECK(scanned(panel, blank));
+        sender.frame(1, first);
+        run_ms(panel, 20);
+        CHECK(scanned(panel, first));
+        CHECK_EQ(panel.ingest_.get_late(), 1u);
+
+        panel.on_shutdown();
+    }
+
+    void test_rectangles(uint16_t port)
+    {
+        uint16_t expected[LINES] = {0x0001, 0x0003, 0x0007, 0x000F, 0x001F, 0x003F, 0x007F};
+
+        TestPanel panel;
+        start_panel(panel, port, false);
+        Sender sender(port);
+        uint32_t sequence = 1;
+        sender.frame(sequence++, expected);
+        run_ms(panel, 20);
+        CHECK(scanned(panel, expected));
+
+        // A rectangle inside the frame leaves the pixels around it alone
+        const std::vector<uint32_t> ones = {0xFF, 0xFF, 0xFF};
+        sender.rect(sequence++, 4, 2, 8, 3, ones);
+        apply_rect(expected, 4, 2, 8, 3, ones);
+        run_ms(panel, 20);
+        CHECK(scanned(panel, expected));
+
+        // Rectangles in quick succession, several per loop() and the scanner picking up only some:
+        // each one lands on top of all the ones before
+        const int RECTS = 12;
+        for (int i = 0; i < RECTS; i++)
+        {
+            const int x = (i * 5) % 14;
+            const int y = i % 6;
+            const std::vector<uint32_t> words = {i % 2 != 0 ? 0x0u : 0x3u, 0x1u};
+            sender.rect(sequence++, x, y, 2, 2, words);
+            apply_rect(expected, x, y, 2, 2, words);
+            if (i % 3 == 2)
+                run_ms(panel, 1);
+        }
+        run_ms(panel, 20);
+        CHECK(scanned(panel, expected));
+
+        // Cut off at the right and bottom edge: columns 12-15 of lines 5 and 6 are shown
+        const std::vector<uint32_t> edge = {0xFF, 0xFF, 0xFF, 0xFF};
+        sender.rect(sequence++, 12, 5, 8, 4, edge);
+        apply_rect(expected, 12, 5, 8, 4, edge);
+        run_ms(panel, 20);
+        CHECK(scanned(panel, expected));
+        CHECK_EQ(panel.ingest_.get_dropped(), 0u);
+
+        // A payload a word short, one a byte too long, only a header, and a rectangle past the
+        // right edge are all dropped
+        const std::vector<uint32_t> zeros = {0, 0, 0};
+        sender.rect(sequence++, 0, 0, 8, 3, zeros, 0, -4);
+        sender.rect(sequence++, 0, 0, 8, 3, zeros, 0, 1);
+        sender.rect(sequence++, 0, 0, 8, 3, {}, 0, 0);
+        sender.rect(sequence++, COLUMNS, 0, 8, 3, zeros);
+        run_ms(panel, 20);
+        CHECK(scanned(panel, expected));
+        CHECK_EQ(panel.ingest_.get_dropped(), 4u);
+
+        panel.on_shutdown();
+    }
+
+    void test_levels(uint16_t port)
+    {
+        TestPanel panel;
+        start_panel(panel, port, true);
+        Sender sender(port);
+
+        // Line 3, columns 0-7 at brightness 0-7 and 8-15 at 8-15: plane b holds bit b of the column
+        std::vector<uint32_t> planes;
+        for (int plane = 0; plane < BRIGHTNESS_BITS; plane++)
+        {
+            uint32_t word = 0;
+            for (int column = 0; column < COLUMNS; column++)
+                word |= ((column >> plane) & 1) << column;
+            planes.push_back(word);
+        }
+        sender.rect(1, 0, 3, COLUMNS, 1, planes, INGEST_LEVELS);
+        run_ms(panel, 20);
+        for (int plane = 0; plane < BRIGHTNESS_BITS; plane++)
+        {
+            CHECK_EQ(panel.scanned_row(3, plane), planes[plane]);
+            CHECK_EQ(panel.scanned_row(2, plane), 0u);
+        }
+
+        // Without the flag a rectangle is full brightness in every plane
+        sender.rect(2, 4, 1, 4, 1, {0x5});
+        run_ms(panel, 20);
+        for (int plane = 0; plane < BRIGHTNESS_BITS; plane++)
+        {
+            CHECK_EQ(panel.scanned_row(1, plane), 0x50u);
+            CHECK_EQ(panel.scanned_row(3, plane), planes[plane]);
+        }
+        CHECK_EQ(panel.ingest_.get_dropped(), 0u);
+
+        panel.on_shutdown();
+    }
+
+} // namespace
+
+int main()
+{
+    const uint16_t port = 47000 + getpid() % 1000 * 3;
+    test_sequence(port);
+    test_rectangles(port + 1);
+    test_levels(port + 2);
+    return sim::check_result("ingest_loopback_test");
+}
@@ -0,0 +1,85 @@
+// A marquee waits scroll_delay at the start of its text only, then moves one column every
+// scroll_speed ms, also once its ring positions have wrapped around.
+
+#include "74HC595Display.h"
+#include "check.h"
+#include "esp32_sim.h"
+#include "virtual_clock.h"
+
+#include <algorithm>
+
+using namespace esphome;
+using namespace esphome::LedDisplay_ns;
+
+namespace
+{
+
+    class TestPanel : public LedDisplayComponent
+    {
+    public:
+        using LedDisplayComponent::frame_dirty_;
+        using LedDisplayComponent::marquee_step_;
+    };
+
+    void test_at_start()
+    {
+        Marquee marquee;
+        marquee.init(7, 40, 1, &get_font(FONT_5X7));
+        marquee.set_text("A text a lot longer than the forty columns of the window");
+        CHECK(marquee.at_start());
+        int at_start = 0;
+        for (int i = 0; i < 1000; i++)
+        {
+            marquee.step(true);
+            if (marquee.at_start())
+                at_start++;
+        }
+        CHECK_EQ(at_start, 0);
+        marquee.restart();
+        CHECK(marquee.at_start());
+    }
+
+    void test_no_pause_mid_text()
+    {
+        TestPanel panel;
+        panel.set_num_chips(5);
+        panel.set_num_chip_lines(7);
+        panel.set_scroll(true);
+        panel.set_scroll_speed(10);
+        panel.set_scroll_delay(1000);
+        panel.set_scroll_mode(ScrollMode::CONTINUOUS);
+        panel.setup();
+        panel.marquee("A text a lot longer than the forty columns of the window");
+
+        // One step per 10 ms after the first second, however often the ring has wrapped
+        const uint32_t start = millis();
+        uint32_t steps = 0, first = 0, last = 0, longest_gap = 0;
+        for (uint32_t ms = 1; ms <= 5000; ms++)
+        {
+            sim::get_clock().set_us((uint64_t)(start + ms) * 1000);
+            panel.frame_dirty_ = false;
+            panel.marquee_step_(millis());
+            if (!panel.frame_dirty_)
+                continue;
+            if (steps == 0)
+                first = ms;
+            else
+                longest_gap = std::max(longest_gap, ms - last);
+            last = ms;
+            steps++;
+        }
+        CHECK_EQ(first, 1000u);
+        CHECK_EQ(longest_gap, 10u);
+        CHECK_EQ(steps, 401u);
+
+        panel.on_shutdown();
+    }
+
+} // namespace
+
+int main()
+{
+    test_at_start();
+    test_no_pause_mid_text();
+    return sim::check_result("marquee_test");
+}
@@ -0,0 +1,240 @@
+// The row scan runs from the timer: rows are lit one at a time in order, each for its slot, with
+// the row's pixels on the chain outputs, and loop() never waits for any of it. Flipped rows only
+// swap the pins of the lines in use. Blank rows are only skipped when low_power asks for it.
+
+#include "74HC595Display.h"
+#include "check.h"
+#include "esp32_sim.h"
+#include "shift_register_chain.h"
+#include "virtual_clock.h"
+
+#include <vector>
+
+using namespace esphome;
+using namespace esphome::LedDisplay_ns;
+
+namespace
+{
+
+    const int ROW_PINS[] = {32, 33, 25, 26, 27, 14, 12};
+    const int LINES = 7;
+
+    class TestPanel : public LedDisplayComponent
+    {
+    public:
+        using LedDisplayComponent::frames_;
+    };
+
+    int row_of(int pin)
+    {
+        for (int line = 0; line < LINES; line++)
+        {
+            if (ROW_PINS[line] == pin)
+                return line;
+        }
+        return -1;
+    }
+
+    void test_sequence()
+    {
+        TestPanel panel;
+        panel.set_num_chips(2);
+        panel.set_num_chip_lines(LINES);
+        panel.set_refresh_rate(100);
+        panel.setup();
+        CHECK(!panel.is_failed());
+
+        // A diagonal, row y lights columns y and 15 - y
+        for (int y = 0; y < LINES; y++)
+        {
+            panel.draw_pixel_at(y, y);
+            panel.draw_pixel_at(15 - y, y);
+        }
+        panel.display();
+
+        sim::ShiftRegisterChain chain(16, 5, 17, 16);
+        int lit = 0, expected = 0, order_errors = 0, content_errors = 0, overlaps = 0, rises = 0;
+        uint64_t since = 0, lit_us = 0;
+        const int listener = sim::add_pin_listener([&](int pin, bool level) {
+            const int line = row_of(pin);
+            if (line < 0)
+                return;
+            const uint64_t now = sim::get_clock().now_us();
+            if (level)
+            {
+                if (lit != 0)
+                    overlaps++;
+                lit++;
+                rises++;
+                since = now;
+                if (line != expected)
+                    order_errors++;
+                expected = (line + 1) % LINES;
+                for (int column = 0; column < 16; column++)
+                {
+                    if (chain.get_column(column) != (column == line || column == 15 - line))
+                        content_errors++;
+                }
+            }
+            else
+            {
+                lit--;
+                lit_us += now - since;
+            }
+        });
+
+        // Start counting at a frame start
+        sim::run_for(20000);
+        while (!sim::pin_level(ROW_PINS[0]))
+            sim::run_for(1);
+        expected = 1;
+        rises = 0;
+        lit_us = 0;
+        const uint32_t frames = panel.frames_;
+        sim::run_for(1000000);
+
+        CHECK_EQ(order_errors, 0);
+        CHECK_EQ(content_errors, 0);
+        CHECK_EQ(overlaps, 0);
+        CHECK_NEAR(panel.frames_ - frames, 100u, 1u);
+        CHECK_NEAR(rises, 100 * LINES, LINES);
+        // The row on-time is the whole slot, there is only the latch pulse in between
+        CHECK_NEAR(lit_us, 1000000u, 20000u);
+
+        sim::remove_pin_listener(listener);
+        panel.on_shutdown();
+        CHECK_EQ(sim::armed_timers(), 0);
+    }
+
+    void test_loop_does_not_block()
+    {
+        TestPanel panel;
+        panel.set_num_chips(20);
+        panel.set_num_chip_lines(LINES);
+        panel.set_refresh_rate(100);
+        panel.set_scroll(true);
+        panel.set_scroll_speed(10);
+        panel.set_writer([](LedDisplayComponent &it) { it.printdigit("A long text that scrolls through the whole panel"); });
+        panel.setup();
+        panel.update();
+
+        // Every loop() returns without the clock moving: no shift delays, no waiting for rows
+        const uint64_t start = sim::get_clock().now_us();
+        uint64_t blocked = 0;
+        for (int ms = 0; ms < 1000; ms++)
+        {
+            sim::run_until(start + (ms + 1) * 1000ULL);
+            if (ms % 100 == 0)
+                panel.update();
+            const uint64_t before = sim::get_clock().now_us();
+            panel.loop();
+            blocked += sim::get_clock().now_us() - before;
+        }
+        CHECK_EQ(blocked, 0u);
+
+        // The rows keep being scanned while the main loop is busy elsewhere
+        const uint32_t frames = panel.frames_;
+        sim::run_for(500000);
+        CHECK_NEAR(panel.frames_ - frames, 50u, 1u);
+
+        panel.on_shutdown();
+    }
+
+    void test_flip_rows()
+    {
+        // 5 lines on the default 7 row pins: flipped, line 0 is on the fifth pin and the last two stay unused
+        const int lines = 5;
+        TestPanel panel;
+        panel.set_num_chips(1);
+        panel.set_num_chip_lines(lines);
+        panel.set_flip_rows(true);
+        panel.setup();
+        CHECK(!panel.is_failed());
+
+        // Row y lights column y only
+        for (int y = 0; y < lines; y++)
+            panel.draw_pixel_at(y, y);
+        panel.display();
+
+        sim::ShiftRegisterChain chain(16, 5, 17, 8);
+        int rises = 0, wrong_pin = 0, spare_pin = 0;
+        const int listener = sim::add_pin_listener([&](int pin, bool level) {
+            const int index = row_of(pin);
+            if (index < 0 || !level)
+                return;
+            rises++;
+            if (index >= lines)
+            {
+                spare_pin++;
+                return;
+            }
+            // the pin lights the line its column belongs to
+            const int line = lines - 1 - index;
+            for (int column = 0; column < 8; column++)
+            {
+                if (chain.get_column(column) != (column == line))
+                    wrong_pin++;
+            }
+        });
+        sim::run_for(100000);
+        sim::remove_pin_listener(listener);
+
+        CHECK(rises >= 8 * lines);
+        CHECK_EQ(wrong_pin, 0);
+        CHECK_EQ(spare_pin, 0);
+        panel.on_shutdown();
+    }
+
+    /// Times each row pin went high in 100 ms, with pixels on rows 0 and 3 only.
+    std::vector<int> rises_with_blank_rows(bool skip_blank_rows, bool configure)
+    {
+        TestPanel panel;
+        panel.set_num_chips(1);
+        panel.set_num_chip_lines(LINES);
+        panel.set_refresh_rate(100);
+        if (configure)
+            panel.set_skip_blank_rows(skip_blank_rows);
+        panel.setup();
+        CHECK(!panel.is_failed());
+        panel.draw_pixel_at(1, 0);
+        panel.draw_pixel_at(2, 3);
+        panel.display();
+
+        std::vector<int> rises(LINES, 0);
+        const int listener = sim::add_pin_listener([&](int pin, bool level) {
+            const int line = row_of(pin);
+            if (line >= 0 && level)
+                rises[line]++;
+        });
+        sim::run_for(100000);
+        sim::remove_pin_listener(listener);
+        panel.on_shutdown();
+        return rises;
+    }
+
+    void test_blank_rows()
+    {
+        // Without a low_power block every row is scanned, blank or not
+        for (int rises : rises_with_blank_rows(false, false))
+            CHECK_NEAR(rises, 10, 1);
+        // Skipping them is what low_power turns on
+        const std::vector<int> skipped = rises_with_blank_rows(true, true);
+        for (int line = 0; line < LINES; line++)
+        {
+            if (line == 0 || line == 3)
+                CHECK_NEAR(skipped[line], 10, 1);
+            else
+                CHECK_EQ(skipped[line], 0);
+        }
+    }
+
+} // namespace
+
+int main()
+{
+    test_sequence();
+    test_loop_does_not_block();
+    test_flip_rows();
+    test_blank_rows();
+    return sim::check_result("scan_test");
+}
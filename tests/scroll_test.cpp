@@ -0,0 +1,89 @@
+// scroll_left() moves the content one column, and loop() keeps it there: with scroll on the
+// timeline goes on from the new column, with scroll off the column stays until the next call.
+
+#include "74HC595Display.h"
+#include "check.h"
+#include "esp32_sim.h"
+#include "virtual_clock.h"
+
+using namespace esphome;
+using namespace esphome::LedDisplay_ns;
+
+namespace
+{
+
+    class TestPanel : public LedDisplayComponent
+    {
+    public:
+        using LedDisplayComponent::scroll_offset_;
+    };
+
+    void set_ms(uint32_t ms) { sim::get_clock().set_us((uint64_t)ms * 1000); }
+
+    void setup_panel(TestPanel &panel, bool scroll)
+    {
+        panel.set_num_chips(2);
+        panel.set_num_chip_lines(7);
+        panel.set_scroll(scroll);
+        panel.set_scroll_speed(100);
+        panel.set_scroll_delay(1000);
+        panel.set_scroll_mode(ScrollMode::CONTINUOUS);
+        panel.set_writer([](LedDisplayComponent &it) { it.printdigit("Wider than 16 columns"); });
+        panel.setup();
+        panel.update();
+    }
+
+    void test_scroll_on()
+    {
+        TestPanel panel;
+        const uint32_t start = millis();
+        setup_panel(panel, true);
+        panel.loop();
+        CHECK_EQ(panel.scroll_offset_, 0);
+
+        // In the delay, the text starts moving from the next column
+        set_ms(start + 200);
+        panel.scroll_left();
+        panel.loop();
+        CHECK_EQ(panel.scroll_offset_, 1);
+        set_ms(start + 299);
+        panel.loop();
+        CHECK_EQ(panel.scroll_offset_, 1);
+        set_ms(start + 300);
+        panel.loop();
+        CHECK_EQ(panel.scroll_offset_, 2);
+
+        // While moving, it stays one column ahead
+        panel.scroll_left();
+        panel.scroll_left();
+        panel.loop();
+        CHECK_EQ(panel.scroll_offset_, 4);
+        set_ms(start + 400);
+        panel.loop();
+        CHECK_EQ(panel.scroll_offset_, 5);
+
+        panel.on_shutdown();
+    }
+
+    void test_scroll_off()
+    {
+        TestPanel panel;
+        const uint32_t start = millis();
+        setup_panel(panel, false);
+        for (int i = 0; i < 3; i++)
+            panel.scroll_left();
+        set_ms(start + 5000);
+        panel.loop();
+        CHECK_EQ(panel.scroll_offset_, 3);
+
+        panel.on_shutdown();
+    }
+
+} // namespace
+
+int main()
+{
+    test_scroll_on();
+    test_scroll_off();
+    return sim::check_result("scroll_test");
+}
@@ -0,0 +1,157 @@
+// Two panels on the shared shift clock, latch and clear pins take turns: never two rows lit at
+// once, no latch while a row is lit, each keeps its own refresh rate, and one can be switched off
+// and on again without disturbing the other.
+
+#include "74HC595Display.h"
+#include "check.h"
+#include "esp32_sim.h"
+#include "virtual_clock.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace esphome;
+using namespace esphome::LedDisplay_ns;
+
+namespace
+{
+
+    const std::vector<int> ROWS_A = {32, 33, 25, 26, 27, 14, 12};
+    const std::vector<int> ROWS_B = {2, 4, 13, 15, 19};
+    const int LATCH = 17;
+
+    bool contains(const std::vector<int> &pins, int pin) { return std::find(pins.begin(), pins.end(), pin) != pins.end(); }
+
+    /// Follows the row and latch pins of both panels.
+    class Watch
+    {
+    public:
+        Watch()
+        {
+            // it may start with a row lit
+            for (int pin : ROWS_A)
+                this->lit_a_ += sim::pin_level(pin);
+            for (int pin : ROWS_B)
+                this->lit_b_ += sim::pin_level(pin);
+            this->listener_ = sim::add_pin_listener([this](int pin, bool level) { this->on_pin_(pin, level); });
+        }
+        ~Watch() { sim::remove_pin_listener(this->listener_); }
+
+        int overlaps{0};  // a row of both panels lit
+        int bad_latches{0}; // a latch with any row lit
+        int frames_a{0};  // rises of the first row
+        int frames_b{0};
+        int rises_a{0};   // rises of any row
+
+    protected:
+        void on_pin_(int pin, bool level)
+        {
+            if (pin == LATCH)
+            {
+                if (level && (this->lit_a_ + this->lit_b_) != 0)
+                    this->bad_latches++;
+                return;
+            }
+            if (contains(ROWS_A, pin))
+            {
+                this->lit_a_ += level ? 1 : -1;
+                if (level)
+                {
+                    this->rises_a++;
+                    this->frames_a += pin == ROWS_A[0];
+                }
+            }
+            else if (contains(ROWS_B, pin))
+            {
+                this->lit_b_ += level ? 1 : -1;
+                if (level)
+                    this->frames_b += pin == ROWS_B[0];
+            }
+            else
+            {
+                return;
+            }
+            if (this->lit_a_ != 0 && this->lit_b_ != 0)
+                this->overlaps++;
+        }
+
+        int lit_a_{0};
+        int lit_b_{0};
+        int listener_{0};
+    };
+
+    void run_for_ms(uint32_t ms)
+    {
+        sim::run_until(sim::get_clock().now_us() + ms * 1000ULL);
+    }
+
+    void check_shared(bool gray_scale)
+    {
+        LedDisplayComponent a, b;
+        a.set_num_chips(2);
+        a.set_num_chip_lines(7);
+        a.set_refresh_rate(100);
+        a.set_gray_scale(gray_scale);
+        if (gray_scale)
+            a.set_intensity(9);
+        b.set_num_chips(3);
+        b.set_num_chip_lines(5);
+        b.set_row_pins({2, 4, 13, 15, 19});
+        b.set_refresh_rate(150);
+        a.setup();
+        b.setup();
+        CHECK(!a.is_failed() && !b.is_failed());
+        CHECK_EQ(get_scan_scheduler().get_panels(), 2);
+
+        a.fill(COLOR_ON);
+        a.display();
+        b.fill(COLOR_ON);
+        b.display();
+        run_for_ms(200);
+
+        {
+            Watch watch;
+            run_for_ms(1000);
+            CHECK_EQ(watch.overlaps, 0);
+            CHECK_EQ(watch.bad_latches, 0);
+            CHECK_NEAR(watch.frames_a, gray_scale ? 100 * BRIGHTNESS_BITS : 100, gray_scale ? 8 : 2);
+            CHECK_NEAR(watch.frames_b, 150, 2);
+        }
+
+        // A off: its rows stay dark and B keeps its rate
+        a.turn_on_off(false);
+        run_for_ms(100);
+        {
+            Watch watch;
+            run_for_ms(1000);
+            CHECK_EQ(watch.rises_a, 0);
+            CHECK_NEAR(watch.frames_b, 150, 2);
+            CHECK_EQ(watch.bad_latches, 0);
+        }
+
+        // And back on
+        a.turn_on_off(true);
+        run_for_ms(100);
+        {
+            Watch watch;
+            run_for_ms(1000);
+            CHECK_EQ(watch.overlaps, 0);
+            CHECK_EQ(watch.bad_latches, 0);
+            CHECK_NEAR(watch.frames_a, gray_scale ? 100 * BRIGHTNESS_BITS : 100, gray_scale ? 8 : 2);
+            CHECK_NEAR(watch.frames_b, 150, 2);
+        }
+
+        a.on_shutdown();
+        b.on_shutdown();
+        CHECK_EQ(get_scan_scheduler().get_panels(), 0);
+        CHECK_EQ(sim::armed_timers(), 0);
+    }
+
+} // namespace
+
+int main()
+{
+    check_shared(false);
+    check_shared(true);
+    return sim::check_result("shared_scan_test");
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdio>
+
+// Minimal checks for the tests: a failed check is reported and the test carries on, the exit code
+// of main() says whether any failed.
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+        namespace sim
+        {
+
+            inline int &check_failures()
+            {
+                static int failures = 0;
+                return failures;
+            }
+
+            inline bool check(bool ok, const char *file, int line, const char *expression)
+            {
+                if (!ok)
+                {
+                    fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+                    check_failures()++;
+                }
+                return ok;
+            }
+
+            template <typename A, typename B>
+            inline bool check_eq(const A &a, const B &b, const char *file, int line, const char *expression)
+            {
+                if (a == b)
+                    return true;
+                fprintf(stderr, "%s:%d: check failed: %s (%lld != %lld)\n", file, line, expression, (long long)a, (long long)b);
+                check_failures()++;
+                return false;
+            }
+
+            template <typename A, typename B, typename T>
+            inline bool check_near(const A &a, const B &b, const T &tolerance, const char *file, int line, const char *expression)
+            {
+                if (a <= b + tolerance && b <= a + tolerance)
+                    return true;
+                fprintf(stderr, "%s:%d: check failed: %s (%g and %g differ by more than %g)\n", file, line, expression,
+                        (double)a, (double)b, (double)tolerance);
+                check_failures()++;
+                return false;
+            }
+
+            /// Exit code of a test's main().
+            inline int check_result(const char *test)
+            {
+                if (check_failures() == 0)
+                    printf("%s: all checks passed\n", test);
+                else
+                    printf("%s: %d checks failed\n", test, check_failures());
+                return check_failures() == 0 ? 0 : 1;
+            }
+
+        } // namespace sim
+    } // namespace LedDisplay_ns
+} // namespace esphome
+
+#define CHECK(expression) esphome::LedDisplay_ns::sim::check((expression), __FILE__, __LINE__, #expression)
+#define CHECK_EQ(a, b) esphome::LedDisplay_ns::sim::check_eq((a), (b), __FILE__, __LINE__, #a " == " #b)
+#define CHECK_NEAR(a, b, tolerance) esphome::LedDisplay_ns::sim::check_near((a), (b), (tolerance), __FILE__, __LINE__, #a " ~ " #b)
@@ -0,0 +1,279 @@
+#include "esp32_sim.h"
+#include "virtual_clock.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <driver/gpio.h>
+#include <driver/spi_master.h>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <soc/gpio_reg.h>
+
+// The ESP-IDF calls the component makes, on top of the virtual clock. Single threaded: timer
+// callbacks only run from run_until(), like a timer task that preempts the main loop between calls.
+
+struct esp_timer
+{
+    esp_timer_cb_t callback;
+    void *arg;
+    bool armed;
+    uint64_t due;
+};
+
+struct spi_device_t
+{
+    spi_host_device_t host;
+    int clock_speed_hz;
+    uint32_t flags;
+};
+
+struct sim_semaphore
+{
+    bool taken;
+};
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+        namespace sim
+        {
+
+            static std::vector<esp_timer *> timers;
+            static bool levels[PIN_COUNT];
+            static std::vector<std::pair<int, PinListener>> listeners;
+            static int next_listener = 0;
+            static spi_bus_config_t spi_buses[3];
+            static uint32_t gpio_set_level_ns = 0;
+            static uint32_t reg_write_ns = 0;
+            static uint32_t pending_ns = 0;
+
+            static void charge(uint32_t ns)
+            {
+                pending_ns += ns;
+                get_clock().advance_us(pending_ns / 1000);
+                pending_ns %= 1000;
+            }
+
+            static void set_pin(int pin, bool level)
+            {
+                if (pin < 0 || pin >= PIN_COUNT || levels[pin] == level)
+                    return;
+                levels[pin] = level;
+                for (auto &listener : listeners)
+                    listener.second(pin, level);
+            }
+
+            void run_until(uint64_t until_us)
+            {
+                VirtualClock &clock = get_clock();
+                for (;;)
+                {
+                    esp_timer *next = nullptr;
+                    for (esp_timer *timer : timers)
+                    {
+                        if (timer->armed && timer->due <= until_us && (next == nullptr || timer->due < next->due))
+                            next = timer;
+                    }
+                    if (next == nullptr)
+                        break;
+                    if (next->due > clock.now_us())
+                        clock.set_us(next->due);
+                    next->armed = false;
+                    next->callback(next->arg);
+                }
+                if (clock.now_us() < until_us)
+                    clock.set_us(until_us);
+            }
+
+            void run_for(uint64_t us) { run_until(get_clock().now_us() + us); }
+
+            bool pin_level(int pin) { return pin >= 0 && pin < PIN_COUNT && levels[pin]; }
+
+            int add_pin_listener(PinListener listener)
+            {
+                listeners.emplace_back(next_listener, std::move(listener));
+                return next_listener++;
+            }
+
+            void remove_pin_listener(int id)
+            {
+                for (auto it = listeners.begin(); it != listeners.end(); ++it)
+                {
+                    if (it->first == id)
+                    {
+                        listeners.erase(it);
+                        return;
+                    }
+                }
+            }
+
+            int armed_timers()
+            {
+                int armed = 0;
+                for (esp_timer *timer : timers)
+                    armed += timer->armed;
+                return armed;
+            }
+
+            void set_write_costs(uint32_t gpio_ns, uint32_t reg_ns)
+            {
+                gpio_set_level_ns = gpio_ns;
+                reg_write_ns = reg_ns;
+                pending_ns = 0;
+            }
+
+        } // namespace sim
+    } // namespace LedDisplay_ns
+} // namespace esphome
+
+using namespace esphome::LedDisplay_ns;
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args, esp_timer_handle_t *out_handle)
+{
+    *out_handle = new esp_timer{create_args->callback, create_args->arg, false, 0};
+    sim::timers.push_back(*out_handle);
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    if (timer == nullptr || timer->armed)
+        return ESP_ERR_INVALID_STATE;
+    timer->armed = true;
+    timer->due = sim::get_clock().now_us() + timeout_us;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    if (timer == nullptr || !timer->armed)
+        return ESP_ERR_INVALID_STATE;
+    timer->armed = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    if (timer == nullptr || timer->armed)
+        return ESP_ERR_INVALID_STATE;
+    for (auto it = sim::timers.begin(); it != sim::timers.end(); ++it)
+    {
+        if (*it == timer)
+        {
+            sim::timers.erase(it);
+            break;
+        }
+    }
+    delete timer;
+    return ESP_OK;
+}
+
+int64_t esp_timer_get_time() { return sim::get_clock().now_us(); }
+
+esp_err_t gpio_reset_pin(gpio_num_t gpio_num) { return gpio_num >= 0 && gpio_num < sim::PIN_COUNT ? ESP_OK : ESP_ERR_INVALID_ARG; }
+
+esp_err_t gpio_set_direction(gpio_num_t gpio_num, gpio_mode_t /*mode*/) { return gpio_reset_pin(gpio_num); }
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level)
+{
+    sim::charge(sim::gpio_set_level_ns);
+    sim::set_pin(gpio_num, level != 0);
+    return ESP_OK;
+}
+
+void sim_reg_write(uint32_t reg, uint32_t value)
+{
+    if (reg != GPIO_OUT_W1TS_REG && reg != GPIO_OUT_W1TC_REG)
+    {
+        fprintf(stderr, "write to unknown register 0x%08x\n", (unsigned)reg);
+        abort();
+    }
+    sim::charge(sim::reg_write_ns);
+    for (int pin = 0; pin < 32; pin++)
+    {
+        if (value & (1UL << pin))
+            sim::set_pin(pin, reg == GPIO_OUT_W1TS_REG);
+    }
+}
+
+void *heap_caps_malloc(size_t size, uint32_t /*caps*/) { return malloc(size); }
+void heap_caps_free(void *ptr) { free(ptr); }
+
+esp_err_t spi_bus_initialize(spi_host_device_t host_id, const spi_bus_config_t *bus_config, spi_dma_chan_t /*dma_chan*/)
+{
+    sim::spi_buses[host_id] = *bus_config;
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_add_device(spi_host_device_t host_id, const spi_device_interface_config_t *dev_config, spi_device_handle_t *handle)
+{
+    *handle = new spi_device_t{host_id, dev_config->clock_speed_hz, dev_config->flags};
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_remove_device(spi_device_handle_t handle)
+{
+    delete handle;
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_free(spi_host_device_t host_id)
+{
+    sim::spi_buses[host_id] = {};
+    return ESP_OK;
+}
+
+esp_err_t spi_device_polling_transmit(spi_device_handle_t handle, spi_transaction_t *trans_desc)
+{
+    // Mode 0: data set up while the clock is low, sampled on the rising edge
+    const spi_bus_config_t &bus = sim::spi_buses[handle->host];
+    const uint8_t *bytes = static_cast<const uint8_t *>(trans_desc->tx_buffer);
+    for (size_t i = 0; i < trans_desc->length; i++)
+    {
+        const uint8_t bit = (handle->flags & SPI_DEVICE_TXBIT_LSBFIRST) ? i % 8 : 7 - i % 8;
+        sim::set_pin(bus.mosi_io_num, (bytes[i / 8] >> bit) & 1);
+        sim::set_pin(bus.sclk_io_num, true);
+        sim::set_pin(bus.sclk_io_num, false);
+    }
+    sim::get_clock().advance_us(((uint64_t)trans_desc->length * 1000000 + handle->clock_speed_hz - 1) / handle->clock_speed_hz);
+    return ESP_OK;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t /*task*/, const char * /*name*/, uint32_t /*stack_depth*/, void * /*parameters*/,
+                                   UBaseType_t /*priority*/, TaskHandle_t * /*created_task*/, BaseType_t /*core_id*/)
+{
+    return pdFAIL;
+}
+
+void vTaskDelete(TaskHandle_t /*task*/) {}
+
+uint32_t ulTaskNotifyTake(BaseType_t /*clear_count_on_exit*/, TickType_t /*ticks_to_wait*/) { return 0; }
+
+BaseType_t xTaskNotifyGive(TaskHandle_t /*task*/) { return pdPASS; }
+
+SemaphoreHandle_t xSemaphoreCreateMutex() { return new sim_semaphore{false}; }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t /*ticks_to_wait*/)
+{
+    if (semaphore->taken)
+    {
+        // Nothing else runs to give it back
+        fprintf(stderr, "mutex taken twice, this would deadlock\n");
+        abort();
+    }
+    semaphore->taken = true;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    if (!semaphore->taken)
+        return pdFALSE;
+    semaphore->taken = false;
+    return pdTRUE;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+        namespace sim
+        {
+
+            static const int PIN_COUNT = 40;
+
+            /// Run the esp_timer callbacks that come due up to `until_us` on the virtual clock, earliest
+            /// first and each at its own time, then move the clock to `until_us`. A callback that
+            /// delays moves the clock with it, like the shift delays do on the real timer task.
+            void run_until(uint64_t until_us);
+            void run_for(uint64_t us);
+
+            /// Level of a pin as last driven by gpio_set_level(), the GPIO_OUT registers or an SPI bus.
+            bool pin_level(int pin);
+
+            /// Called with every level change of a pin, after the level is stored.
+            using PinListener = std::function<void(int pin, bool level)>;
+            /// Returns the id to remove it with.
+            int add_pin_listener(PinListener listener);
+            void remove_pin_listener(int id);
+
+            /// Number of armed esp_timers, for checking that a stopped scan left nothing running.
+            int armed_timers();
+
+            /// Virtual time taken by every gpio_set_level() call and every GPIO_OUT register write, free
+            /// unless a benchmark sets it. Fractions of a µs add up over the following writes.
+            void set_write_costs(uint32_t gpio_set_level_ns, uint32_t reg_write_ns);
+
+        } // namespace sim
+    } // namespace LedDisplay_ns
+} // namespace esphome
@@ -0,0 +1,48 @@
+#include "shift_register_chain.h"
+#include "esp32_sim.h"
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+        namespace sim
+        {
+
+            ShiftRegisterChain::ShiftRegisterChain(int data_pin, int clock_pin, int latch_pin, uint16_t length)
+                : data_pin_(data_pin), clock_pin_(clock_pin), latch_pin_(latch_pin), length_(length),
+                  stages_(length), outputs_(length)
+            {
+                this->listener_ = add_pin_listener([this](int pin, bool level) { this->on_pin_(pin, level); });
+            }
+
+            ShiftRegisterChain::~ShiftRegisterChain() { remove_pin_listener(this->listener_); }
+
+            std::vector<bool> ShiftRegisterChain::get_columns() const
+            {
+                std::vector<bool> columns(this->length_);
+                for (uint16_t column = 0; column < this->length_; column++)
+                    columns[column] = this->get_column(column);
+                return columns;
+            }
+
+            void ShiftRegisterChain::on_pin_(int pin, bool level)
+            {
+                if (!level)
+                    return;
+                if (pin == this->clock_pin_)
+                {
+                    for (uint16_t stage = this->length_ - 1; stage > 0; stage--)
+                        this->stages_[stage] = this->stages_[stage - 1];
+                    this->stages_[0] = pin_level(this->data_pin_);
+                    this->clocks_++;
+                }
+                else if (pin == this->latch_pin_)
+                {
+                    this->outputs_ = this->stages_;
+                    this->latches_++;
+                }
+            }
+
+        } // namespace sim
+    } // namespace LedDisplay_ns
+} // namespace esphome
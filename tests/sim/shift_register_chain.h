@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+        namespace sim
+        {
+
+            /// A chain of `length` 74HC595 outputs on the simulated pins, following them while it exists.
+            ///
+            /// A rising edge of the shift clock moves every stage one further and takes the data pin
+            /// level into stage 0, a rising edge of the latch copies the stages to the outputs. What
+            /// falls off the end of the chain is lost, like on the real chips.
+            class ShiftRegisterChain
+            {
+            public:
+                ShiftRegisterChain(int data_pin, int clock_pin, int latch_pin, uint16_t length);
+                ~ShiftRegisterChain();
+
+                /// Output of the bit shifted in `length - 1 - column` clocks before the last latch,
+                /// so column 0 is the first of a row shifted in column order.
+                bool get_column(uint16_t column) const { return this->outputs_[this->length_ - 1 - column]; }
+                /// All outputs in column order.
+                std::vector<bool> get_columns() const;
+                uint16_t get_length() const { return this->length_; }
+
+                uint32_t get_clocks() const { return this->clocks_; }
+                uint32_t get_latches() const { return this->latches_; }
+
+            protected:
+                void on_pin_(int pin, bool level);
+
+                int data_pin_;
+                int clock_pin_;
+                int latch_pin_;
+                uint16_t length_;
+                std::vector<bool> stages_;
+                std::vector<bool> outputs_;
+                uint32_t clocks_{0};
+                uint32_t latches_{0};
+                int listener_;
+            };
+
+        } // namespace sim
+    } // namespace LedDisplay_ns
+} // namespace esphome
@@ -0,0 +1,79 @@
+#include "virtual_clock.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+        namespace sim
+        {
+
+            uint64_t VirtualClock::now_us() const
+            {
+                if (!this->real_time_)
+                    return this->now_us_;
+                const auto elapsed = std::chrono::steady_clock::now() - this->real_start_;
+                return this->now_us_ + std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+            }
+
+            void VirtualClock::set_us(uint64_t us) { this->now_us_ = us; }
+
+            void VirtualClock::advance_us(uint64_t us) { this->now_us_ += us; }
+
+            void VirtualClock::follow_real_time(bool on)
+            {
+                if (on == this->real_time_)
+                    return;
+                // Carry on from the time reached, in either direction
+                const uint64_t now = this->now_us();
+                this->real_start_ = std::chrono::steady_clock::now();
+                this->now_us_ = now;
+                this->real_time_ = on;
+            }
+
+            VirtualClock &get_clock()
+            {
+                static VirtualClock clock;
+                return clock;
+            }
+
+        } // namespace sim
+    } // namespace LedDisplay_ns
+
+    uint32_t millis() { return LedDisplay_ns::sim::get_clock().now_us() / 1000; }
+
+    uint32_t micros() { return LedDisplay_ns::sim::get_clock().now_us(); }
+
+    void delay(uint32_t ms) { delayMicroseconds(ms * 1000); }
+
+    void delayMicroseconds(uint32_t us)
+    {
+        LedDisplay_ns::sim::VirtualClock &clock = LedDisplay_ns::sim::get_clock();
+        if (clock.follows_real_time())
+            std::this_thread::sleep_for(std::chrono::microseconds(us));
+        else
+            clock.advance_us(us);
+    }
+
+    void esp_log_printf_(int level, const char *tag, int line, const char *format, ...)
+    {
+        static const int max_level = getenv("LED_DISPLAY_LOG") != nullptr ? atoi(getenv("LED_DISPLAY_LOG")) : ESPHOME_LOG_LEVEL_WARN;
+        if (level > max_level)
+            return;
+        static const char *const LETTERS = "-EWICDV";
+        fprintf(stderr, "[%c][%s:%d]: ", LETTERS[level], tag, line);
+        va_list arg;
+        va_start(arg, format);
+        vfprintf(stderr, format, arg);
+        va_end(arg);
+        fputc('\n', stderr);
+    }
+
+} // namespace esphome
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace esphome
+{
+    namespace LedDisplay_ns
+    {
+        namespace sim
+        {
+
+            /// Time of the HAL stand-in, read by micros() and millis().
+            ///
+            /// It only moves when a test sets it or a delay advances it, so timing is exact and a
+            /// run takes no longer than its work. Tests with the host build's scan thread let it
+            /// follow the steady clock instead, delays then sleep.
+            class VirtualClock
+            {
+            public:
+                uint64_t now_us() const;
+                void set_us(uint64_t us);
+                void advance_us(uint64_t us);
+
+                /// Follow the steady clock from the current time on, or stand still again. Only switch
+                /// while no scan thread is running.
+                void follow_real_time(bool on);
+                bool follows_real_time() const { return this->real_time_; }
+
+            protected:
+                std::atomic<uint64_t> now_us_{0};
+                std::atomic<bool> real_time_{false};
+                std::chrono::steady_clock::time_point real_start_;
+            };
+
+            /// The clock behind micros(), millis() and the delays.
+            VirtualClock &get_clock();
+
+        } // namespace sim
+    } // namespace LedDisplay_ns
+} // namespace esphome
@@ -0,0 +1,109 @@
+// Every chain gets the right bit stream: the pins driven by each transport are fed into modelled
+// 74HC595 chains, and whenever a row is switched on every chain must hold its share of that row.
+
+#include "74HC595Display.h"
+#include "check.h"
+#include "esp32_sim.h"
+#include "shift_register_chain.h"
+#include "virtual_clock.h"
+
+#include <memory>
+#include <vector>
+
+using namespace esphome;
+using namespace esphome::LedDisplay_ns;
+
+namespace
+{
+
+    const int ROW_PINS[] = {32, 33, 25, 26, 27, 14, 12};
+    const int LINES = 7;
+    const int CHIPS = 12;
+    const int COLUMNS = CHIPS * 8;
+    const int SHIFT_DATA = 16;
+    const int SHIFT_CLOCK = 5;
+    const int LATCH = 17;
+
+    bool pixel(int x, int y) { return ((x * 7 + y * 13 + x * y) % 5) < 2; }
+
+    void run_case(const char *name, OutputTransportType type, const std::vector<uint8_t> &data_pins, bool mirror, bool invert)
+    {
+        LedDisplayComponent panel;
+        panel.set_num_chips(CHIPS);
+        panel.set_num_chip_lines(LINES);
+        panel.set_transport(type);
+        panel.set_reverse(mirror);
+        for (uint8_t pin : data_pins)
+            panel.add_parallel_data_pin(pin);
+        panel.setup();
+        if (!CHECK(!panel.is_failed()))
+        {
+            fprintf(stderr, "  in %s\n", name);
+            return;
+        }
+        panel.invert_on_off(invert);
+        for (int y = 0; y < LINES; y++)
+        {
+            for (int x = 0; x < COLUMNS; x++)
+                panel.draw_pixel_at(x, y, pixel(x, y) ? COLOR_ON : COLOR_OFF);
+        }
+        panel.display();
+
+        // One chain per data pin, the columns split evenly over them
+        const int chains = data_pins.empty() ? 1 : data_pins.size();
+        const int chain_bits = COLUMNS / chains;
+        std::vector<std::unique_ptr<sim::ShiftRegisterChain>> models;
+        for (int c = 0; c < chains; c++)
+            models.emplace_back(new sim::ShiftRegisterChain(data_pins.empty() ? SHIFT_DATA : data_pins[c], SHIFT_CLOCK, LATCH, chain_bits));
+
+        int rows = 0, errors = 0;
+        const int listener = sim::add_pin_listener([&](int pin, bool level) {
+            int line = -1;
+            for (int i = 0; i < LINES; i++)
+            {
+                if (ROW_PINS[i] == pin)
+                    line = i;
+            }
+            if (line < 0 || !level)
+                return;
+            rows++;
+            for (int c = 0; c < chains; c++)
+            {
+                for (int j = 0; j < chain_bits; j++)
+                {
+                    // A mirrored panel is shifted last column first, the split follows the shift order
+                    const int shifted = c * chain_bits + j;
+                    const int column = mirror ? COLUMNS - 1 - shifted : shifted;
+                    if (models[c]->get_column(j) != (pixel(column, line) != invert))
+                        errors++;
+                }
+            }
+        });
+
+        sim::run_for(100000);
+        sim::remove_pin_listener(listener);
+
+        if (!CHECK(rows >= 8 * LINES) || !CHECK_EQ(errors, 0))
+            fprintf(stderr, "  in %s: %d rows, %d wrong outputs\n", name, rows, errors);
+        // Exactly one row of clocks per latch, nothing left over in the chains
+        for (auto &model : models)
+            CHECK_EQ(model->get_clocks(), model->get_latches() * chain_bits);
+
+        panel.on_shutdown();
+    }
+
+} // namespace
+
+int main()
+{
+    run_case("GPIO", TRANSPORT_GPIO, {}, false, false);
+    run_case("GPIO mirrored, inverted", TRANSPORT_GPIO, {}, true, true);
+    run_case("SPI", TRANSPORT_SPI, {}, false, false);
+    run_case("SPI mirrored, inverted", TRANSPORT_SPI, {}, true, true);
+    run_case("2 parallel chains", TRANSPORT_PARALLEL, {2, 4}, false, false);
+    run_case("3 parallel chains", TRANSPORT_PARALLEL, {2, 4, 13}, false, false);
+    run_case("4 parallel chains mirrored", TRANSPORT_PARALLEL, {2, 4, 13, 15}, true, false);
+    run_case("6 parallel chains inverted", TRANSPORT_PARALLEL, {2, 4, 13, 15, 19, 21}, false, true);
+    run_case("8 parallel chains", TRANSPORT_PARALLEL, {2, 4, 13, 15, 19, 21, 22, 23}, false, false);
+    return sim::check_result("waveform_test");
+}